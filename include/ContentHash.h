@@ -0,0 +1,121 @@
+#ifndef CONTENTHASH_H
+#define CONTENTHASH_H
+
+#include "ThreadPool.h"
+
+#include <vector>
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+/**
+ * Content Hashing
+ *
+ * A fast non-cryptographic 64-bit hash of a byte range in the style of
+ * xxHash64. The main loop keeps four independent lanes so the compiler can
+ * vectorize and pipeline it; contentHash() additionally splits large ranges
+ * into chunks hashed in parallel on the shared ThreadPool.
+ *
+ * Usage example:
+ * uint64_t h = contentHash(M.raw(), M.getRows() * M.getCols() * sizeof(T));
+ */
+
+namespace hashing {
+
+const uint64_t PRIME1 = 11400714785074694791ULL;
+const uint64_t PRIME2 = 14029467366897019727ULL;
+const uint64_t PRIME3 = 1609587929392839161ULL;
+const uint64_t PRIME4 = 9650029242287828579ULL;
+const uint64_t PRIME5 = 2870177450012600261ULL;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t readWord(const unsigned char* bytes) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+inline uint64_t step(uint64_t accumulator, uint64_t word) {
+    return rotateLeft(accumulator + word * PRIME2, 31) * PRIME1;
+}
+
+inline uint64_t merge(uint64_t hash, uint64_t lane) {
+    return (hash ^ step(0, lane)) * PRIME1 + PRIME4;
+}
+
+} // namespace hashing
+
+/**
+ * Hashes a byte range on the calling thread.
+ *
+ * @param data Start of the range.
+ * @param length Number of bytes in the range.
+ * @param seed Value mixed into the hash.
+ * @return The 64-bit hash.
+ */
+inline uint64_t hashBytes(const void* data, size_t length, uint64_t seed = 0) {
+    using namespace hashing;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + length;
+    uint64_t hash;
+    if (length >= 32) {
+        uint64_t lanes[4] = {
+            seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1
+        };
+        for (; p + 32 <= end; p += 32)
+            for (int l = 0; l < 4; ++l)
+                lanes[l] = step(lanes[l], readWord(p + 8 * l));
+        hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) +
+               rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+        for (int l = 0; l < 4; ++l)
+            hash = merge(hash, lanes[l]);
+    } else {
+        hash = seed + PRIME5;
+    }
+    hash += length;
+    for (; p + 8 <= end; p += 8)
+        hash = rotateLeft(hash ^ step(0, readWord(p)), 27) * PRIME1 + PRIME4;
+    for (; p < end; ++p)
+        hash = rotateLeft(hash ^ (*p * PRIME5), 11) * PRIME1;
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/**
+ * Hashes a byte range, splitting ranges larger than a chunk into chunks
+ * hashed in parallel. The result depends only on the bytes and the seed.
+ *
+ * @param data Start of the range.
+ * @param length Number of bytes in the range.
+ * @param seed Value mixed into the hash.
+ * @return The 64-bit hash.
+ */
+inline uint64_t contentHash(
+    const void* data, size_t length, uint64_t seed = 0
+) {
+    const size_t chunkSize = 1 << 20;
+    if (length <= chunkSize) return hashBytes(data, length, seed);
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    size_t chunkCount = (length + chunkSize - 1) / chunkSize;
+    std::vector<uint64_t> chunkHashes(chunkCount);
+    ThreadPool::instance().parallelFor(chunkCount, [&](size_t c) {
+        size_t start = c * chunkSize;
+        chunkHashes[c] = hashBytes(
+            bytes + start, std::min(chunkSize, length - start), seed
+        );
+    });
+    return hashBytes(
+        chunkHashes.data(), chunkHashes.size() * sizeof(uint64_t),
+        seed ^ length
+    );
+}
+
+#endif // CONTENTHASH_H
@@ -0,0 +1,1044 @@
+#ifndef DISTRIBUTEDMATRIX_H
+#define DISTRIBUTEDMATRIX_H
+
+#include "MatrixLib.h"
+#include "ThreadPool.h"
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <type_traits>
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include <iostream>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+
+/**
+ * Distributed Matrices
+ *
+ * Multi-process dense linear algebra: a matrix is distributed 2D
+ * block-cyclically over a grid of processes, and summa() multiplies
+ * distributed matrices with the SUMMA algorithm, broadcasting one panel of
+ * each operand along process rows and columns per step. Each process
+ * multiplies its panels on the shared ThreadPool.
+ *
+ * Processes exchange data through a Transport. LocalTransport connects
+ * processes on one host through POSIX shared memory; other transports
+ * (e.g. TCP sockets between nodes) only need to implement send() and
+ * receive().
+ *
+ * Usage example:
+ * LocalCluster::run(4, [&](Transport& transport) {
+ *     ProcessGrid grid(transport, 2, 2);
+ *     auto dA = DistributedMatrix<double>::scatter(grid, A, 64);
+ *     auto dB = DistributedMatrix<double>::scatter(grid, B, 64);
+ *     Matrix<double> C = summa(dA, dB).gather();
+ *     if (transport.rank() == 0) C.print();
+ * });
+ */
+
+/* ************************************************************************* */
+/* ****************************** Transports ******************************* */
+/* ************************************************************************* */
+
+/**
+ * Thrown by a transport when the process at the other end of a transfer
+ * has exited, which usually means that it failed itself.
+ */
+class PeerExitedError : public std::runtime_error {
+public:
+    explicit PeerExitedError(int peer) : std::runtime_error(
+        "Process " + std::to_string(peer) + " exited during a transfer."
+    ) {}
+};
+
+/**
+ * Point-to-point communication between a fixed set of processes, numbered
+ * 0 to size() - 1. Messages between a pair of processes are delivered in
+ * order, and the receiver must know the size of each message.
+ */
+class Transport {
+public:
+    virtual ~Transport() {}
+
+    /**
+     * Returns the number of this process.
+     *
+     * @return Integer rank in [0, size()).
+     */
+    virtual int rank() const = 0;
+
+    /**
+     * Returns the number of processes.
+     *
+     * @return Integer count of processes.
+     */
+    virtual int size() const = 0;
+
+    /**
+     * Sends a message to another process. May block until the receiver
+     * has accepted it.
+     *
+     * @param dest Rank of the receiving process.
+     * @param data Start of the message.
+     * @param bytes Length of the message.
+     * @throws std::runtime_error If the message cannot be delivered.
+     */
+    virtual void send(int dest, const void* data, size_t bytes) = 0;
+
+    /**
+     * Receives a message from another process, blocking until it arrives.
+     *
+     * @param source Rank of the sending process.
+     * @param data Buffer the message is written to.
+     * @param bytes Length of the message.
+     * @throws PeerExitedError If the sender exits.
+     * @throws std::runtime_error If the message cannot be received.
+     */
+    virtual void receive(int source, void* data, size_t bytes) = 0;
+
+    /**
+     * Sends a message from one process of a group to all the others. Every
+     * member of the group must call it with the same arguments.
+     *
+     * @param root Rank of the process holding the message.
+     * @param group Ranks of the members, including root.
+     * @param data The message on root, its destination elsewhere.
+     * @param bytes Length of the message.
+     */
+    virtual void broadcast(
+        int root, const std::vector<int>& group, void* data, size_t bytes
+    ) {
+        if (rank() != root) {
+            receive(root, data, bytes);
+            return;
+        }
+        for (int member : group)
+            if (member != root) send(member, data, bytes);
+    }
+};
+
+/**
+ * Transport between processes on one host. Each ordered pair of processes
+ * owns a slot in a POSIX shared memory segment and a Unix socket pair:
+ * the sender copies up to one slot of data into shared memory and writes
+ * its length to the socket, and the receiver copies it out and
+ * acknowledges on the socket, after which the slot may be reused. Payloads
+ * never pass through the kernel, while the sockets provide blocking,
+ * ordering and detection of exited peers.
+ *
+ * Constructed by LocalCluster::run().
+ */
+class LocalTransport : public Transport {
+private:
+    int myRank, count;
+    unsigned char* segment;
+    size_t segmentBytes, slotBytes;
+    // Socket ends for sending to and receiving from each rank
+    std::vector<int> sendFds, receiveFds;
+
+    friend class LocalCluster;
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    LocalTransport(const LocalTransport&) = delete;
+    LocalTransport& operator=(const LocalTransport&) = delete;
+
+    /**
+     * Closes this process's socket ends and unmaps the shared segment.
+     */
+    ~LocalTransport() {
+        for (int r = 0; r < count; ++r) {
+            if (sendFds[r] >= 0) ::close(sendFds[r]);
+            if (receiveFds[r] >= 0) ::close(receiveFds[r]);
+        }
+        ::munmap(segment, segmentBytes);
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Transport ***************************** */
+    /* ********************************************************************* */
+
+    int rank() const override {
+        return myRank;
+    }
+
+    int size() const override {
+        return count;
+    }
+
+    void send(int dest, const void* data, size_t bytes) override {
+        checkPeer(dest);
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        unsigned char* slot = slotFor(myRank, dest);
+        while (bytes > 0) {
+            uint64_t chunk = std::min(bytes, slotBytes);
+            std::memcpy(slot, p, chunk);
+            writeFully(sendFds[dest], &chunk, sizeof(chunk), dest);
+            char ack;
+            readFully(sendFds[dest], &ack, sizeof(ack), dest);
+            p += chunk;
+            bytes -= chunk;
+        }
+    }
+
+    void receive(int source, void* data, size_t bytes) override {
+        checkPeer(source);
+        unsigned char* p = static_cast<unsigned char*>(data);
+        const unsigned char* slot = slotFor(source, myRank);
+        while (bytes > 0) {
+            uint64_t chunk;
+            readFully(receiveFds[source], &chunk, sizeof(chunk), source);
+            if (chunk > bytes) throw std::runtime_error(
+                "Received a longer message than expected."
+            );
+            std::memcpy(p, slot, chunk);
+            char ack = 0;
+            writeFully(receiveFds[source], &ack, sizeof(ack), source);
+            p += chunk;
+            bytes -= chunk;
+        }
+    }
+
+private:
+    /* ********************************************************************* */
+    /* ************************** Helper Functions ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs the transport of one process. Takes ownership of the
+     * socket ends and of this process's mapping of the segment.
+     */
+    LocalTransport(
+        int rank, int count, unsigned char* segment, size_t slotBytes,
+        std::vector<int> sendFds, std::vector<int> receiveFds
+    ) :
+        myRank(rank), count(count), segment(segment),
+        segmentBytes(static_cast<size_t>(count) * count * slotBytes),
+        slotBytes(slotBytes),
+        sendFds(std::move(sendFds)), receiveFds(std::move(receiveFds)) {}
+
+    /**
+     * Returns the shared memory slot for messages from source to dest.
+     */
+    unsigned char* slotFor(int source, int dest) const {
+        return segment + (static_cast<size_t>(source) * count + dest)
+                         * slotBytes;
+    }
+
+    /**
+     * Validates the rank of the other end of a transfer.
+     */
+    void checkPeer(int peer) const {
+        if (peer < 0 || peer >= count || peer == myRank)
+            throw std::invalid_argument("Invalid peer rank.");
+    }
+
+    /**
+     * Writes a whole buffer to a socket.
+     */
+    static void writeFully(int fd, const void* data, size_t bytes, int peer) {
+        const char* p = static_cast<const char*>(data);
+        while (bytes > 0) {
+            ssize_t written = ::send(fd, p, bytes, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EPIPE || errno == ECONNRESET)
+                    throw PeerExitedError(peer);
+                throw std::runtime_error(
+                    std::string("Transport write failed: ")
+                    + std::strerror(errno)
+                );
+            }
+            p += written;
+            bytes -= static_cast<size_t>(written);
+        }
+    }
+
+    /**
+     * Reads a whole buffer from a socket.
+     */
+    static void readFully(int fd, void* data, size_t bytes, int peer) {
+        char* p = static_cast<char*>(data);
+        while (bytes > 0) {
+            ssize_t received = ::read(fd, p, bytes);
+            if (received < 0) {
+                if (errno == EINTR) continue;
+                if (errno == ECONNRESET) throw PeerExitedError(peer);
+                throw std::runtime_error(
+                    std::string("Transport read failed: ")
+                    + std::strerror(errno)
+                );
+            }
+            if (received == 0) throw PeerExitedError(peer);
+            p += received;
+            bytes -= static_cast<size_t>(received);
+        }
+    }
+};
+
+/**
+ * Runs a function in several processes on this host, connected by a
+ * LocalTransport.
+ */
+class LocalCluster {
+public:
+    /**
+     * Runs body as rank 0 in the calling process and as ranks 1 to
+     * processes - 1 in forked child processes, and waits for all of them.
+     * Each child starts with a copy of the caller's memory, so data
+     * prepared before the call is available to every rank. Children flush
+     * std::cout and exit without running exit handlers.
+     *
+     * An exception thrown by body in a child is reported to the caller
+     * with its message. Processes that only failed because a peer exited
+     * are reported last, so the error names the process that failed first.
+     *
+     * @param processes Number of processes, at least 1.
+     * @param body Callable taking Transport& run by every process.
+     * @param slotBytes Size of the shared memory slot of each ordered pair
+     *                  of processes; larger messages are sent in chunks.
+     * @throws std::runtime_error If setting up the processes fails or a
+     *                            child process fails.
+     * @throws Any exception thrown by body in the calling process, unless
+     *         it is a PeerExitedError caused by a failed child.
+     */
+    static void run(
+        int processes, const std::function<void(Transport&)>& body,
+        size_t slotBytes = 1 << 20
+    ) {
+        if (processes < 1 || slotBytes == 0) throw std::invalid_argument(
+            "A cluster needs at least one process and a nonempty slot."
+        );
+        size_t segmentBytes =
+            static_cast<size_t>(processes) * processes * slotBytes;
+        unsigned char* segment = createSegment(segmentBytes);
+        // ends[2 * (s * processes + d)] sends from s to d, the next receives
+        std::vector<int> ends(2 * processes * processes, -1);
+        for (int s = 0; s < processes; ++s) {
+            for (int d = 0; d < processes; ++d) {
+                if (s == d) continue;
+                if (::socketpair(AF_UNIX, SOCK_STREAM, 0,
+                                 &ends[2 * (s * processes + d)]) != 0) {
+                    int error = errno;
+                    closeAll(ends);
+                    ::munmap(segment, segmentBytes);
+                    throw std::runtime_error(
+                        std::string("Failed to create sockets: ")
+                        + std::strerror(error)
+                    );
+                }
+            }
+        }
+        std::cout.flush();
+        std::fflush(stdout);
+        std::vector<pid_t> children;
+        // Read ends of the pipes carrying each child's error message
+        std::vector<int> errorFds;
+        for (int r = 1; r < processes; ++r) {
+            int errorPipe[2] = { -1, -1 };
+            pid_t pid = -1;
+            if (::pipe(errorPipe) == 0) pid = ::fork();
+            if (pid == 0) {
+                ::close(errorPipe[0]);
+                int status = 0;
+                try {
+                    std::vector<int> sendFds, receiveFds;
+                    connect(r, processes, ends, sendFds, receiveFds);
+                    LocalTransport transport(
+                        r, processes, segment, slotBytes, sendFds, receiveFds
+                    );
+                    body(transport);
+                    std::cout.flush();
+                } catch (const PeerExitedError& e) {
+                    status = PEER_EXITED;
+                    reportError(errorPipe[1], e.what());
+                } catch (const std::exception& e) {
+                    status = FAILED;
+                    reportError(errorPipe[1], e.what());
+                } catch (...) {
+                    status = FAILED;
+                }
+                std::fflush(stdout);
+                ::_exit(status);
+            }
+            if (pid < 0) {
+                int error = errno;
+                closeAll(ends);
+                if (errorPipe[0] >= 0) errorFds.push_back(errorPipe[0]);
+                if (errorPipe[1] >= 0) errorFds.push_back(errorPipe[1]);
+                closeAll(errorFds);
+                ::munmap(segment, segmentBytes);
+                for (pid_t child : children) {
+                    ::kill(child, SIGKILL);
+                    ::waitpid(child, nullptr, 0);
+                }
+                throw std::runtime_error(
+                    std::string("Failed to start process: ")
+                    + std::strerror(error)
+                );
+            }
+            ::close(errorPipe[1]);
+            children.push_back(pid);
+            errorFds.push_back(errorPipe[0]);
+        }
+        std::exception_ptr error;
+        bool peerExited = false;
+        try {
+            std::vector<int> sendFds, receiveFds;
+            connect(0, processes, ends, sendFds, receiveFds);
+            LocalTransport transport(
+                0, processes, segment, slotBytes, sendFds, receiveFds
+            );
+            body(transport);
+        } catch (const PeerExitedError&) {
+            error = std::current_exception();
+            peerExited = true;
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // The first child that failed on its own, else the first that failed
+        int failedRank = 0, failedStatus = 0;
+        std::string failure;
+        for (size_t c = 0; c < children.size(); ++c) {
+            int status = 0;
+            while (::waitpid(children[c], &status, 0) < 0 && errno == EINTR) {}
+            std::string message = readError(errorFds[c]);
+            int code = WIFEXITED(status) ? WEXITSTATUS(status) : FAILED;
+            if (code != 0 && (failedRank == 0 ||
+                (failedStatus == PEER_EXITED && code != PEER_EXITED))) {
+                failedRank = static_cast<int>(c) + 1;
+                failedStatus = code;
+                failure = message;
+            }
+        }
+        closeAll(errorFds);
+        if (error && (!peerExited || failedRank == 0))
+            std::rethrow_exception(error);
+        if (failedRank != 0) throw std::runtime_error(
+            "Process " + std::to_string(failedRank) + " failed"
+            + (failure.empty() ? std::string(".") : ": " + failure)
+        );
+    }
+
+private:
+    // Exit statuses of a child that failed on its own or because a peer
+    // exited
+    static const int FAILED = 1;
+    static const int PEER_EXITED = 2;
+
+    /**
+     * Writes a child's error message to its pipe. The message is truncated
+     * to PIPE_BUF bytes, so that the write neither blocks nor interleaves.
+     */
+    static void reportError(int fd, const char* message) {
+        size_t length = std::min(std::strlen(message),
+                                 static_cast<size_t>(PIPE_BUF));
+        while (::write(fd, message, length) < 0 && errno == EINTR) {}
+    }
+
+    /**
+     * Reads the error message of an exited child from its pipe.
+     */
+    static std::string readError(int fd) {
+        std::string message;
+        char buffer[PIPE_BUF];
+        for (;;) {
+            ssize_t received = ::read(fd, buffer, sizeof(buffer));
+            if (received < 0 && errno == EINTR) continue;
+            if (received <= 0) return message;
+            message.append(buffer, static_cast<size_t>(received));
+        }
+    }
+
+    /**
+     * Creates and maps an anonymous POSIX shared memory segment. The name
+     * is unlinked immediately; forked processes share the mapping.
+     */
+    static unsigned char* createSegment(size_t bytes) {
+        static int counter = 0;
+        std::string name = "/matrixlib-" + std::to_string(::getpid())
+                         + "-" + std::to_string(counter++);
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error(
+            std::string("Failed to create shared memory: ")
+            + std::strerror(errno)
+        );
+        ::shm_unlink(name.c_str());
+        void* address = MAP_FAILED;
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+            address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd, 0);
+        }
+        int error = errno;
+        ::close(fd);
+        if (address == MAP_FAILED) throw std::runtime_error(
+            std::string("Failed to map shared memory: ")
+            + std::strerror(error)
+        );
+        return static_cast<unsigned char*>(address);
+    }
+
+    /**
+     * Takes the socket ends of one rank out of the list and closes the
+     * ends that belong to other ranks, so that exited peers are detected.
+     */
+    static void connect(
+        int rank, int processes, std::vector<int>& ends,
+        std::vector<int>& sendFds, std::vector<int>& receiveFds
+    ) {
+        sendFds.assign(processes, -1);
+        receiveFds.assign(processes, -1);
+        for (int s = 0; s < processes; ++s) {
+            for (int d = 0; d < processes; ++d) {
+                int* pair = &ends[2 * (s * processes + d)];
+                if (s == rank && d != rank) std::swap(sendFds[d], pair[0]);
+                if (d == rank && s != rank) std::swap(receiveFds[s], pair[1]);
+            }
+        }
+        closeAll(ends);
+    }
+
+    /**
+     * Closes every open descriptor in a list and marks it closed.
+     */
+    static void closeAll(std::vector<int>& fds) {
+        for (int& fd : fds) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+    }
+};
+
+/* ************************************************************************* */
+/* ***************************** Process Grid ****************************** */
+/* ************************************************************************* */
+
+/**
+ * Arranges the processes of a transport in a row-major grid: rank r is in
+ * process row r / cols and process column r % cols.
+ */
+class ProcessGrid {
+private:
+    Transport* transport;
+    int rows, cols;
+
+public:
+    /**
+     * Constructs a grid over all processes of a transport.
+     *
+     * @param transport The transport connecting the processes.
+     * @param rows Number of process rows.
+     * @param cols Number of process columns.
+     * @throws std::invalid_argument If rows * cols is not the number of
+     *                               processes.
+     */
+    ProcessGrid(Transport& transport, int rows, int cols) :
+        transport(&transport), rows(rows), cols(cols) {
+        if (rows < 1 || cols < 1 || rows * cols != transport.size())
+            throw std::invalid_argument(
+                "Process grid does not match the number of processes."
+            );
+    }
+
+    /**
+     * Returns the transport connecting the processes.
+     *
+     * @return Reference to the transport.
+     */
+    Transport& getTransport() const {
+        return *transport;
+    }
+
+    /**
+     * Returns the number of process rows.
+     *
+     * @return Integer count of process rows.
+     */
+    int getRows() const {
+        return rows;
+    }
+
+    /**
+     * Returns the number of process columns.
+     *
+     * @return Integer count of process columns.
+     */
+    int getCols() const {
+        return cols;
+    }
+
+    /**
+     * Returns the process row of this process.
+     */
+    int myRow() const {
+        return transport->rank() / cols;
+    }
+
+    /**
+     * Returns the process column of this process.
+     */
+    int myCol() const {
+        return transport->rank() % cols;
+    }
+
+    /**
+     * Returns the rank of the process at a grid position.
+     */
+    int rankAt(int row, int col) const {
+        return row * cols + col;
+    }
+
+    /**
+     * Returns the ranks of the processes in a process row.
+     */
+    std::vector<int> rowGroup(int row) const {
+        std::vector<int> group;
+        for (int c = 0; c < cols; ++c)
+            group.push_back(rankAt(row, c));
+        return group;
+    }
+
+    /**
+     * Returns the ranks of the processes in a process column.
+     */
+    std::vector<int> colGroup(int col) const {
+        std::vector<int> group;
+        for (int r = 0; r < rows; ++r)
+            group.push_back(rankAt(r, col));
+        return group;
+    }
+
+    /**
+     * Returns the ranks of all processes.
+     */
+    std::vector<int> allRanks() const {
+        std::vector<int> group;
+        for (int r = 0; r < rows * cols; ++r)
+            group.push_back(r);
+        return group;
+    }
+
+    /**
+     * Checks whether two grids arrange the same processes identically.
+     */
+    bool operator==(const ProcessGrid& other) const {
+        return transport == other.transport &&
+               rows == other.rows && cols == other.cols;
+    }
+};
+
+/* ************************************************************************* */
+/* ************************** Distributed Matrix *************************** */
+/* ************************************************************************* */
+
+/**
+ * A matrix distributed 2D block-cyclically over a process grid: the
+ * blockSize x blockSize block (I, J) belongs to process (I % gridRows,
+ * J % gridCols), and each process stores its blocks as one local dense
+ * matrix, in order.
+ */
+template<typename T>
+class DistributedMatrix {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Distributed elements are sent as raw bytes.");
+
+private:
+    ProcessGrid grid;
+    size_t rows, cols, blockSize;
+    Matrix<T> local;
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs a zero-initialized distributed matrix. Every process of
+     * the grid constructs its own part.
+     *
+     * @param grid The process grid.
+     * @param rows Number of rows of the global matrix.
+     * @param cols Number of columns of the global matrix.
+     * @param blockSize Number of rows and columns of each block.
+     * @throws std::invalid_argument If blockSize is zero.
+     */
+    DistributedMatrix(
+        const ProcessGrid& grid, size_t rows, size_t cols, size_t blockSize
+    ) :
+        grid(grid), rows(rows), cols(cols),
+        blockSize(checkedBlockSize(blockSize)),
+        local(
+            localExtent(rows, this->blockSize, grid.myRow(), grid.getRows()),
+            localExtent(cols, this->blockSize, grid.myCol(), grid.getCols())
+        ) {}
+
+    /**
+     * Distributes a matrix that every process holds a copy of, without
+     * communication.
+     *
+     * @param grid The process grid.
+     * @param global The global matrix, identical on every process.
+     * @param blockSize Number of rows and columns of each block.
+     * @return This process's part of the distributed matrix.
+     */
+    static DistributedMatrix<T> distribute(
+        const ProcessGrid& grid, const Matrix<T>& global, size_t blockSize
+    ) {
+        DistributedMatrix<T> result(
+            grid, global.getRows(), global.getCols(), blockSize
+        );
+        result.local = result.extract(global, grid.myRow(), grid.myCol());
+        return result;
+    }
+
+    /**
+     * Distributes a matrix held by one process, sending each process its
+     * blocks.
+     *
+     * @param grid The process grid.
+     * @param global The global matrix on root; ignored elsewhere.
+     * @param blockSize Number of rows and columns of each block.
+     * @param root Rank of the process holding the matrix.
+     * @return This process's part of the distributed matrix.
+     */
+    static DistributedMatrix<T> scatter(
+        const ProcessGrid& grid, const Matrix<T>& global, size_t blockSize,
+        int root = 0
+    ) {
+        Transport& transport = grid.getTransport();
+        uint64_t dimensions[2] = { global.getRows(), global.getCols() };
+        transport.broadcast(
+            root, grid.allRanks(), dimensions, sizeof(dimensions)
+        );
+        DistributedMatrix<T> result(
+            grid, dimensions[0], dimensions[1], blockSize
+        );
+        if (transport.rank() != root) {
+            transport.receive(root, result.local.raw(), result.localBytes());
+            return result;
+        }
+        for (int r = 0; r < grid.getRows(); ++r) {
+            for (int c = 0; c < grid.getCols(); ++c) {
+                Matrix<T> part = result.extract(global, r, c);
+                if (grid.rankAt(r, c) == root) {
+                    result.local = part;
+                } else {
+                    transport.send(
+                        grid.rankAt(r, c), part.raw(),
+                        part.getRows() * part.getCols() * sizeof(T)
+                    );
+                }
+            }
+        }
+        return result;
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Accessors ***************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Returns the number of rows of the global matrix.
+     *
+     * @return Integer count of rows.
+     */
+    size_t getRows() const {
+        return rows;
+    }
+
+    /**
+     * Returns the number of columns of the global matrix.
+     *
+     * @return Integer count of columns.
+     */
+    size_t getCols() const {
+        return cols;
+    }
+
+    /**
+     * Returns the number of rows and columns of each block.
+     *
+     * @return The block size.
+     */
+    size_t getBlockSize() const {
+        return blockSize;
+    }
+
+    /**
+     * Returns the process grid the matrix is distributed over.
+     *
+     * @return Const reference to the grid.
+     */
+    const ProcessGrid& getGrid() const {
+        return grid;
+    }
+
+    /**
+     * Returns the blocks stored by this process, as one dense matrix.
+     *
+     * @return Reference to the local part.
+     */
+    Matrix<T>& getLocal() {
+        return local;
+    }
+
+    /**
+     * Returns the blocks stored by this process, as one dense matrix.
+     *
+     * @return Const reference to the local part.
+     */
+    const Matrix<T>& getLocal() const {
+        return local;
+    }
+
+    /**
+     * Returns the number of global rows or columns stored by a process.
+     *
+     * @param extent Number of global rows or columns.
+     * @param blockSize Number of rows or columns of each block.
+     * @param process Process row or column.
+     * @param processes Number of process rows or columns.
+     * @return The local extent.
+     */
+    static size_t localExtent(
+        size_t extent, size_t blockSize, int process, int processes
+    ) {
+        size_t p = static_cast<size_t>(process);
+        size_t count = static_cast<size_t>(processes);
+        size_t blocks = (extent + blockSize - 1) / blockSize;
+        size_t myBlocks = blocks / count + (p < blocks % count);
+        size_t result = myBlocks * blockSize;
+        // The last block may be partial
+        if (blocks > 0 && (blocks - 1) % count == p)
+            result -= blocks * blockSize - extent;
+        return result;
+    }
+
+    /**
+     * Returns the global index of a local row or column.
+     *
+     * @param index The local index.
+     * @param blockSize Number of rows or columns of each block.
+     * @param process Process row or column holding the index.
+     * @param processes Number of process rows or columns.
+     * @return The global index.
+     */
+    static size_t globalIndex(
+        size_t index, size_t blockSize, int process, int processes
+    ) {
+        size_t blockIndex = index / blockSize * static_cast<size_t>(processes)
+                          + static_cast<size_t>(process);
+        return blockIndex * blockSize + index % blockSize;
+    }
+
+    /* ********************************************************************* */
+    /* ************************** Communication **************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Collects the distributed matrix on one process. Every process of the
+     * grid must call it.
+     *
+     * @param root Rank of the receiving process.
+     * @return The global matrix on root, an empty matrix elsewhere.
+     */
+    Matrix<T> gather(int root = 0) const {
+        Transport& transport = grid.getTransport();
+        if (transport.rank() != root) {
+            transport.send(root, local.raw(), localBytes());
+            return Matrix<T>(0, 0);
+        }
+        Matrix<T> global(rows, cols);
+        for (int r = 0; r < grid.getRows(); ++r) {
+            for (int c = 0; c < grid.getCols(); ++c) {
+                Matrix<T> part(
+                    localExtent(rows, blockSize, r, grid.getRows()),
+                    localExtent(cols, blockSize, c, grid.getCols())
+                );
+                if (grid.rankAt(r, c) == root) {
+                    part = local;
+                } else {
+                    transport.receive(
+                        grid.rankAt(r, c), part.raw(),
+                        part.getRows() * part.getCols() * sizeof(T)
+                    );
+                }
+                place(part, r, c, global);
+            }
+        }
+        return global;
+    }
+
+private:
+    /* ********************************************************************* */
+    /* ************************** Helper Functions ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Validates a block size before it is used to size the local part.
+     */
+    static size_t checkedBlockSize(size_t blockSize) {
+        if (blockSize == 0) throw std::invalid_argument(
+            "Block size must be positive."
+        );
+        return blockSize;
+    }
+
+    /**
+     * Returns the size of the local part in bytes.
+     */
+    size_t localBytes() const {
+        return local.getRows() * local.getCols() * sizeof(T);
+    }
+
+    /**
+     * Copies the blocks of a global matrix owned by a process.
+     */
+    Matrix<T> extract(const Matrix<T>& global, int row, int col) const {
+        Matrix<T> part(
+            localExtent(rows, blockSize, row, grid.getRows()),
+            localExtent(cols, blockSize, col, grid.getCols())
+        );
+        T* out = part.raw();
+        for (size_t i = 0; i < part.getRows(); ++i) {
+            size_t gi = globalIndex(i, blockSize, row, grid.getRows());
+            for (size_t j = 0; j < part.getCols(); j += blockSize) {
+                size_t gj = globalIndex(j, blockSize, col, grid.getCols());
+                size_t width = std::min(blockSize, part.getCols() - j);
+                const T* src = global.raw() + gi * cols + gj;
+                std::copy(src, src + width, out + i * part.getCols() + j);
+            }
+        }
+        return part;
+    }
+
+    /**
+     * Copies the blocks owned by a process into a global matrix.
+     */
+    void place(
+        const Matrix<T>& part, int row, int col, Matrix<T>& global
+    ) const {
+        T* out = global.raw();
+        for (size_t i = 0; i < part.getRows(); ++i) {
+            size_t gi = globalIndex(i, blockSize, row, grid.getRows());
+            for (size_t j = 0; j < part.getCols(); j += blockSize) {
+                size_t gj = globalIndex(j, blockSize, col, grid.getCols());
+                size_t width = std::min(blockSize, part.getCols() - j);
+                const T* src = part.raw() + i * part.getCols() + j;
+                std::copy(src, src + width, out + gi * cols + gj);
+            }
+        }
+    }
+};
+
+/* ************************************************************************* */
+/* ******************************** SUMMA ********************************** */
+/* ************************************************************************* */
+
+/**
+ * Multiplies two distributed matrices with SUMMA. For each block column k
+ * of A, the processes holding it broadcast their panel A(:, k) along their
+ * process row, the processes holding block row k of B broadcast B(k, :)
+ * along their process column, and every process accumulates the product of
+ * the two panels into its part of C. The part is summed in
+ * Accumulator<T>::type over all steps and converted to T once, like the
+ * local kernels. Every process of the grid must call it.
+ *
+ * @param A The left-hand side matrix.
+ * @param B The right-hand side matrix, on the same grid with the same
+ *          block size.
+ * @return The distributed product A * B.
+ * @throws std::invalid_argument If the operands are incompatible.
+ */
+template<typename T>
+DistributedMatrix<T> summa(
+    const DistributedMatrix<T>& A, const DistributedMatrix<T>& B
+) {
+    if (A.getCols() != B.getRows()) throw std::invalid_argument(
+        "Incompatible dimensions for multiplication."
+    );
+    if (!(A.getGrid() == B.getGrid()) ||
+        A.getBlockSize() != B.getBlockSize()) {
+        throw std::invalid_argument(
+            "Operands must share a process grid and block size."
+        );
+    }
+    const ProcessGrid& grid = A.getGrid();
+    Transport& transport = grid.getTransport();
+    size_t blockSize = A.getBlockSize();
+    DistributedMatrix<T> C(grid, A.getRows(), B.getCols(), blockSize);
+    const Matrix<T>& localA = A.getLocal();
+    const Matrix<T>& localB = B.getLocal();
+    size_t m = localA.getRows(), n = localB.getCols();
+    std::vector<int> rowGroup = grid.rowGroup(grid.myRow());
+    std::vector<int> colGroup = grid.colGroup(grid.myCol());
+    // The local block of C is summed over all steps before being stored
+    typedef typename Accumulator<T>::type Acc;
+    std::vector<Acc> sums(m * n, Acc(0));
+    size_t rowBlock = 64;
+    for (size_t k = 0, block = 0; k < A.getCols(); k += blockSize, ++block) {
+        size_t kb = std::min(blockSize, A.getCols() - k);
+        int ownerCol = static_cast<int>(block % grid.getCols());
+        int ownerRow = static_cast<int>(block % grid.getRows());
+        Matrix<T> panelA(m, kb), panelB(kb, n);
+        if (grid.myCol() == ownerCol) {
+            panelA = localA.submatrix(
+                0, block / grid.getCols() * blockSize, m, kb
+            );
+        }
+        if (grid.myRow() == ownerRow) {
+            panelB = localB.submatrix(
+                block / grid.getRows() * blockSize, 0, kb, n
+            );
+        }
+        transport.broadcast(
+            grid.rankAt(grid.myRow(), ownerCol), rowGroup, panelA.raw(),
+            m * kb * sizeof(T)
+        );
+        transport.broadcast(
+            grid.rankAt(ownerRow, grid.myCol()), colGroup, panelB.raw(),
+            kb * n * sizeof(T)
+        );
+        // sums += panelA * panelB, streaming over the rows of panelB
+        const T* a = panelA.raw();
+        const T* b = panelB.raw();
+        ThreadPool::instance().parallelFor(
+            (m + rowBlock - 1) / rowBlock, [&](size_t r) {
+                size_t end = std::min(m, (r + 1) * rowBlock);
+                for (size_t i = r * rowBlock; i < end; ++i) {
+                    Acc* row = sums.data() + i * n;
+                    for (size_t l = 0; l < kb; ++l) {
+                        Acc scale = a[i * kb + l];
+                        const T* source = b + l * n;
+                        for (size_t j = 0; j < n; ++j)
+                            row[j] += scale * source[j];
+                    }
+                }
+            }
+        );
+    }
+    T* c = C.getLocal().raw();
+    for (size_t i = 0; i < m * n; ++i)
+        c[i] = static_cast<T>(sums[i]);
+    return C;
+}
+
+#endif // DISTRIBUTEDMATRIX_H
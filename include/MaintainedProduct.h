@@ -0,0 +1,309 @@
+#ifndef MAINTAINEDPRODUCT_H
+#define MAINTAINEDPRODUCT_H
+
+#include "MatrixLib.h"
+#include "ThreadPool.h"
+
+#include <vector>
+#include <utility>
+
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Maintained Product
+ *
+ * Holds two operands A and B together with their product C = A * B and
+ * keeps C up to date as the operands change, at a cost proportional to
+ * the change instead of a full product:
+ * - Changing elements of A marks their rows dirty; changing elements of B
+ *   marks their columns dirty. The next call to product() recomputes only
+ *   the dirty rows and columns of C.
+ * - rankUpdate(U, V) applies A += U * V^T and C += U * (V^T * B) directly
+ *   in O((m + inner) * n * k) instead of O(m * inner * n).
+ *
+ * All updates run in parallel on the shared ThreadPool. A maintained
+ * product must not be modified from several threads at once.
+ *
+ * Usage example:
+ * MaintainedProduct<double> P(A, B);
+ * P.setRowOfA(3, newRow);
+ * P.rankUpdate(u, v);
+ * P.product().print();
+ */
+template<typename T>
+class MaintainedProduct {
+private:
+    Matrix<T> A, B, C;
+    std::vector<char> rowIsDirty, colIsDirty;
+    std::vector<size_t> dirtyRows, dirtyCols;
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs a maintained product and computes A * B.
+     *
+     * @param A The left-hand side matrix.
+     * @param B The right-hand side matrix.
+     * @throws std::invalid_argument If the dimensions are incompatible.
+     */
+    MaintainedProduct(Matrix<T> A, Matrix<T> B) :
+        A(std::move(A)), B(std::move(B)), C(this->A * this->B),
+        rowIsDirty(this->A.getRows(), 0), colIsDirty(this->B.getCols(), 0) {}
+
+    /* ********************************************************************* */
+    /* ***************************** Accessors ***************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Returns the left-hand side operand.
+     *
+     * @return Const reference to A.
+     */
+    const Matrix<T>& getA() const {
+        return A;
+    }
+
+    /**
+     * Returns the right-hand side operand.
+     *
+     * @return Const reference to B.
+     */
+    const Matrix<T>& getB() const {
+        return B;
+    }
+
+    /**
+     * Returns the product A * B, first recomputing any dirty rows and
+     * columns.
+     *
+     * @return Const reference to the up-to-date product.
+     */
+    const Matrix<T>& product() {
+        refresh();
+        return C;
+    }
+
+    /**
+     * Returns the number of rows of A changed since the last refresh.
+     *
+     * @return Count of dirty rows.
+     */
+    size_t dirtyRowCount() const {
+        return dirtyRows.size();
+    }
+
+    /**
+     * Returns the number of columns of B changed since the last refresh.
+     *
+     * @return Count of dirty columns.
+     */
+    size_t dirtyColCount() const {
+        return dirtyCols.size();
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Mutators ****************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Sets an element of A and marks its row dirty.
+     *
+     * @param row The zero-based index of the row.
+     * @param col The zero-based index of the column.
+     * @param value The new value.
+     */
+    void setA(size_t row, size_t col, T value) {
+        A(row, col) = value;
+        markRow(row);
+    }
+
+    /**
+     * Sets an element of B and marks its column dirty.
+     *
+     * @param row The zero-based index of the row.
+     * @param col The zero-based index of the column.
+     * @param value The new value.
+     */
+    void setB(size_t row, size_t col, T value) {
+        B(row, col) = value;
+        markCol(col);
+    }
+
+    /**
+     * Replaces a row of A and marks it dirty.
+     *
+     * @param row The zero-based index of the row.
+     * @param values A 1 x A.cols matrix holding the new row.
+     */
+    void setRowOfA(size_t row, const Matrix<T>& values) {
+        if (values.getRows() != 1 || values.getCols() != A.getCols())
+            throw std::invalid_argument("Row has the wrong dimensions.");
+        A.setSubmatrix(row, 0, values);
+        markRow(row);
+    }
+
+    /**
+     * Replaces a column of B and marks it dirty.
+     *
+     * @param col The zero-based index of the column.
+     * @param values A B.rows x 1 matrix holding the new column.
+     */
+    void setColumnOfB(size_t col, const Matrix<T>& values) {
+        if (values.getRows() != B.getRows() || values.getCols() != 1)
+            throw std::invalid_argument("Column has the wrong dimensions.");
+        B.setSubmatrix(0, col, values);
+        markCol(col);
+    }
+
+    /**
+     * Applies the rank-k update A += U * V^T and updates the product by
+     * C += U * (V^T * B), without recomputing it.
+     *
+     * @param U An A.rows x k matrix.
+     * @param V An A.cols x k matrix.
+     * @throws std::invalid_argument If the dimensions are incompatible.
+     */
+    void rankUpdate(const Matrix<T>& U, const Matrix<T>& V) {
+        if (U.getRows() != A.getRows() || V.getRows() != A.getCols() ||
+            U.getCols() != V.getCols()) {
+            throw std::invalid_argument(
+                "Incompatible dimensions for rank update."
+            );
+        }
+        // Dirty rows and columns of C are recomputed from the updated
+        // operands on refresh, so the update is valid for the others
+        addProduct(C, U, multiply(V, Op::Transpose, B, Op::None));
+        addProduct(A, U, V.transpose());
+    }
+
+    /**
+     * Recomputes the dirty rows and columns of the product. Falls back to
+     * a full product when that is cheaper.
+     */
+    void refresh() {
+        if (dirtyRows.empty() && dirtyCols.empty()) return;
+        size_t m = A.getRows(), n = B.getCols();
+        if (static_cast<double>(dirtyRows.size()) / m +
+            static_cast<double>(dirtyCols.size()) / n >= 1) {
+            C = A * B;
+        } else {
+            refreshRows();
+            refreshCols();
+        }
+        for (size_t row : dirtyRows)
+            rowIsDirty[row] = 0;
+        for (size_t col : dirtyCols)
+            colIsDirty[col] = 0;
+        dirtyRows.clear();
+        dirtyCols.clear();
+    }
+
+private:
+    /* ********************************************************************* */
+    /* ************************** Helper Functions ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Marks a row of A (and of C) dirty.
+     */
+    void markRow(size_t row) {
+        if (!rowIsDirty[row]) {
+            rowIsDirty[row] = 1;
+            dirtyRows.push_back(row);
+        }
+    }
+
+    /**
+     * Marks a column of B (and of C) dirty.
+     */
+    void markCol(size_t col) {
+        if (!colIsDirty[col]) {
+            colIsDirty[col] = 1;
+            dirtyCols.push_back(col);
+        }
+    }
+
+    /**
+     * Recomputes the dirty rows of C as (dirty rows of A) * B.
+     */
+    void refreshRows() {
+        if (dirtyRows.empty()) return;
+        size_t inner = A.getCols(), n = C.getCols();
+        size_t count = dirtyRows.size();
+        Matrix<T> rows(count, inner);
+        const T* source = getA().raw();
+        T* gathered = rows.raw();
+        for (size_t r = 0; r < count; ++r)
+            std::copy(source + dirtyRows[r] * inner,
+                      source + (dirtyRows[r] + 1) * inner,
+                      gathered + r * inner);
+        const Matrix<T> updated = rows * B;
+        const T* in = updated.raw();
+        T* out = C.raw();
+        for (size_t r = 0; r < count; ++r)
+            std::copy(in + r * n, in + (r + 1) * n, out + dirtyRows[r] * n);
+    }
+
+    /**
+     * Recomputes the dirty columns of C as A * (dirty columns of B).
+     */
+    void refreshCols() {
+        if (dirtyCols.empty()) return;
+        size_t inner = B.getRows(), n = B.getCols(), m = C.getRows();
+        size_t count = dirtyCols.size();
+        Matrix<T> cols(inner, count);
+        const T* source = getB().raw();
+        T* gathered = cols.raw();
+        for (size_t k = 0; k < inner; ++k)
+            for (size_t c = 0; c < count; ++c)
+                gathered[k * count + c] = source[k * n + dirtyCols[c]];
+        const Matrix<T> updated = A * cols;
+        const T* in = updated.raw();
+        T* out = C.raw();
+        for (size_t i = 0; i < m; ++i)
+            for (size_t c = 0; c < count; ++c)
+                out[i * n + dirtyCols[c]] = in[i * count + c];
+    }
+
+    /**
+     * Adds U * W to M in place. Blocks of rows are updated in parallel,
+     * and each row is summed in Accumulator<T>::type before being stored.
+     *
+     * @param M The m x n matrix to update.
+     * @param U An m x k matrix.
+     * @param W A k x n matrix.
+     */
+    static void addProduct(Matrix<T>& M, const Matrix<T>& U,
+                           const Matrix<T>& W) {
+        typedef typename Accumulator<T>::type Acc;
+        size_t m = M.getRows(), n = M.getCols(), k = U.getCols();
+        T* out = M.raw();
+        const T* u = U.raw();
+        const T* w = W.raw();
+        size_t blockSize = 64;
+        ThreadPool::instance().parallelFor(
+            (m + blockSize - 1) / blockSize, [&](size_t b) {
+                size_t end = std::min(m, (b + 1) * blockSize);
+                std::vector<Acc> sums(n);
+                for (size_t i = b * blockSize; i < end; ++i) {
+                    T* row = out + i * n;
+                    std::copy(row, row + n, sums.begin());
+                    for (size_t l = 0; l < k; ++l) {
+                        Acc scale = u[i * k + l];
+                        const T* source = w + l * n;
+                        for (size_t j = 0; j < n; ++j)
+                            sums[j] += scale * source[j];
+                    }
+                    for (size_t j = 0; j < n; ++j)
+                        row[j] = static_cast<T>(sums[j]);
+                }
+            }
+        );
+    }
+};
+
+#endif // MAINTAINEDPRODUCT_H
@@ -0,0 +1,400 @@
+#ifndef MATRIXASYNC_H
+#define MATRIXASYNC_H
+
+#include "MatrixLib.h"
+#include "ThreadPool.h"
+
+#include <memory>
+#include <vector>
+#include <functional>
+
+#include <mutex>
+#include <atomic>
+#include <exception>
+
+/**
+ * Asynchronous Matrix Operations
+ *
+ * multiplyAsync() and transposeAsync() return immediately with a
+ * MatrixFuture. Operations accept futures as operands and are scheduled as
+ * soon as their operands are ready, so a graph of independent operations
+ * runs without blocking the caller and their blocks interleave on the
+ * shared ThreadPool.
+ *
+ * Usage example:
+ * auto AB = multiplyAsync(A, B);
+ * auto CD = multiplyAsync(C, D);
+ * auto result = multiplyAsync(AB, CD).then(
+ *     [](const Matrix<int>& M) { return M.transpose(); }
+ * );
+ * result.get().print();
+ */
+template<typename T>
+class MatrixFuture {
+private:
+    /**
+     * State shared by all copies of a future.
+     */
+    struct State {
+        std::mutex mutex;
+        bool ready = false;
+        std::shared_ptr<const Matrix<T>> value;
+        std::exception_ptr error;
+        std::vector<std::function<void()>> continuations;
+    };
+
+    std::shared_ptr<State> state;
+
+    template<typename U>
+    friend MatrixFuture<U> multiplyAsync(
+        const MatrixFuture<U>& A, Op opA, const MatrixFuture<U>& B, Op opB
+    );
+    template<typename U>
+    friend MatrixFuture<U> transposeAsync(const MatrixFuture<U>& A);
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs a future that is already ready with the given matrix.
+     *
+     * @param value The matrix held by the future.
+     */
+    explicit MatrixFuture(Matrix<T> value) : state(std::make_shared<State>()) {
+        state->ready = true;
+        state->value = std::make_shared<const Matrix<T>>(std::move(value));
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Accessors ***************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Checks whether the operation producing this future has finished.
+     *
+     * @return true if the result (or an error) is available.
+     */
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->ready;
+    }
+
+    /**
+     * Blocks until the result is available, executing pending pool tasks
+     * on the calling thread meanwhile.
+     */
+    void wait() const {
+        ThreadPool::instance().waitUntil([this]() { return isReady(); });
+    }
+
+    /**
+     * Waits for and returns the result of the operation.
+     *
+     * @return Const reference to the result, valid while any copy of this
+     *         future is alive.
+     * @throws Any exception raised by the operation or its operands.
+     */
+    const Matrix<T>& get() const {
+        wait();
+        if (state->error) std::rethrow_exception(state->error);
+        return *state->value;
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Chaining ****************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Schedules a function on the pool once this future is ready.
+     * Errors are propagated to the returned future without invoking it.
+     *
+     * @param continuation Callable taking const Matrix<T>& and returning
+     *                     Matrix<T>.
+     * @return A future holding the value returned by the continuation.
+     */
+    template<typename F>
+    MatrixFuture<T> then(F continuation) const {
+        MatrixFuture<T> next;
+        std::shared_ptr<State> source = state;
+        whenReady([source, next, continuation]() {
+            if (source->error) {
+                next.complete(nullptr, source->error);
+                return;
+            }
+            ThreadPool::instance().submit([source, next, continuation]() {
+                try {
+                    next.complete(std::make_shared<const Matrix<T>>(
+                        continuation(*source->value)
+                    ), nullptr);
+                } catch (...) {
+                    next.complete(nullptr, std::current_exception());
+                }
+            });
+        });
+        return next;
+    }
+
+private:
+    /* ********************************************************************* */
+    /* ************************** Helper Functions ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs a pending future.
+     */
+    MatrixFuture() : state(std::make_shared<State>()) {}
+
+    /**
+     * Registers a callback to run once this future is ready. The callback
+     * runs immediately on the calling thread if the future is already
+     * ready, otherwise on the thread that completes it. It must not block.
+     *
+     * @param callback The callback to run.
+     */
+    void whenReady(std::function<void()> callback) const {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!state->ready) {
+                state->continuations.push_back(std::move(callback));
+                return;
+            }
+        }
+        callback();
+    }
+
+    /**
+     * Registers a callback to run once two futures are both ready.
+     *
+     * @param first The first future to wait for.
+     * @param second The second future to wait for.
+     * @param callback The callback to run.
+     */
+    static void whenAllReady(
+        const MatrixFuture<T>& first, const MatrixFuture<T>& second,
+        std::function<void()> callback
+    ) {
+        std::shared_ptr<std::atomic<int>> remaining =
+            std::make_shared<std::atomic<int>>(2);
+        std::function<void()> arrive = [remaining, callback]() {
+            if (--*remaining == 0) callback();
+        };
+        first.whenReady(arrive);
+        second.whenReady(arrive);
+    }
+
+    /**
+     * Makes the future ready and runs its continuations.
+     *
+     * @param value The result, or null if the operation failed.
+     * @param error The failure, or null if the operation succeeded.
+     */
+    void complete(
+        std::shared_ptr<const Matrix<T>> value, std::exception_ptr error
+    ) const {
+        std::vector<std::function<void()>> continuations;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->value = std::move(value);
+            state->error = error;
+            state->ready = true;
+            continuations.swap(state->continuations);
+        }
+        for (auto& continuation : continuations)
+            continuation();
+        ThreadPool::instance().notifyWaiters();
+    }
+
+    /**
+     * Runs block(0), ..., block(count - 1) as independent pool tasks and
+     * completes this future with the given result once all have finished.
+     *
+     * @param count Number of blocks.
+     * @param block Callable invoked with the index of each block.
+     * @param result The matrix the blocks write into.
+     */
+    void runBlocks(
+        size_t count, std::function<void(size_t)> block,
+        std::shared_ptr<Matrix<T>> result
+    ) const {
+        if (count == 0) {
+            complete(result, nullptr);
+            return;
+        }
+        struct Progress {
+            std::atomic<size_t> remaining;
+            std::mutex mutex;
+            std::exception_ptr error;
+        };
+        std::shared_ptr<Progress> progress = std::make_shared<Progress>();
+        progress->remaining = count;
+        MatrixFuture<T> self = *this;
+        for (size_t b = 0; b < count; ++b) {
+            ThreadPool::instance().submit([self, progress, block, result, b]() {
+                try {
+                    block(b);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(progress->mutex);
+                    if (!progress->error)
+                        progress->error = std::current_exception();
+                }
+                if (--progress->remaining != 0) return;
+                if (progress->error) self.complete(nullptr, progress->error);
+                else self.complete(result, nullptr);
+            });
+        }
+    }
+};
+
+/* ************************************************************************* */
+/* ************************* Asynchronous Operations *********************** */
+/* ************************************************************************* */
+
+/**
+ * Asynchronously multiplies op(A) by op(B) once both operands are ready.
+ * Blocks of the product are scheduled individually on the shared pool.
+ *
+ * @param A Future of the left-hand side matrix.
+ * @param opA The operation applied to A.
+ * @param B Future of the right-hand side matrix.
+ * @param opB The operation applied to B.
+ * @return A future holding op(A) * op(B). It holds std::invalid_argument
+ *         if the dimensions are incompatible.
+ */
+template<typename T>
+MatrixFuture<T> multiplyAsync(
+    const MatrixFuture<T>& A, Op opA, const MatrixFuture<T>& B, Op opB
+) {
+    MatrixFuture<T> result;
+    MatrixFuture<T>::whenAllReady(A, B, [=]() {
+        std::exception_ptr error = A.state->error;
+        if (!error) error = B.state->error;
+        if (error) {
+            result.complete(nullptr, error);
+            return;
+        }
+        std::shared_ptr<const Matrix<T>> left = A.state->value;
+        std::shared_ptr<const Matrix<T>> right = B.state->value;
+        std::shared_ptr<Matrix<T>> product;
+        try {
+            product = std::make_shared<Matrix<T>>(
+                Matrix<T>::allocateProduct(*left, opA, *right, opB)
+            );
+        } catch (...) {
+            result.complete(nullptr, std::current_exception());
+            return;
+        }
+        size_t blockSize = 128;
+        size_t blockCols = (product->cols + blockSize - 1) / blockSize;
+        size_t blockCount =
+            (product->rows + blockSize - 1) / blockSize * blockCols;
+        result.runBlocks(blockCount, [=](size_t b) {
+            Matrix<T>::multiplyBlock(
+                b / blockCols * blockSize, b % blockCols * blockSize,
+                blockSize, *left, opA, *right, opB, *product
+            );
+        }, product);
+    });
+    return result;
+}
+
+/**
+ * Asynchronously multiplies two matrices once both are ready.
+ *
+ * @param A Future of the left-hand side matrix.
+ * @param B Future of the right-hand side matrix.
+ * @return A future holding A * B.
+ */
+template<typename T>
+MatrixFuture<T> multiplyAsync(
+    const MatrixFuture<T>& A, const MatrixFuture<T>& B
+) {
+    return multiplyAsync(A, Op::None, B, Op::None);
+}
+
+/**
+ * Asynchronously multiplies op(A) by op(B). The operands are copied in O(1)
+ * by sharing their storage, so they may be modified or destroyed while the
+ * operation runs.
+ *
+ * @param A The left-hand side matrix.
+ * @param opA The operation applied to A.
+ * @param B The right-hand side matrix.
+ * @param opB The operation applied to B.
+ * @return A future holding op(A) * op(B).
+ */
+template<typename T>
+MatrixFuture<T> multiplyAsync(
+    const Matrix<T>& A, Op opA, const Matrix<T>& B, Op opB
+) {
+    return multiplyAsync(MatrixFuture<T>(A), opA, MatrixFuture<T>(B), opB);
+}
+
+/**
+ * Asynchronously multiplies two matrices. The operands are copied in O(1)
+ * by sharing their storage, so they may be modified or destroyed while the
+ * operation runs.
+ *
+ * @param A The left-hand side matrix.
+ * @param B The right-hand side matrix.
+ * @return A future holding A * B.
+ */
+template<typename T>
+MatrixFuture<T> multiplyAsync(const Matrix<T>& A, const Matrix<T>& B) {
+    return multiplyAsync(A, Op::None, B, Op::None);
+}
+
+/**
+ * Asynchronously transposes a matrix once it is ready.
+ * Blocks of the transpose are scheduled individually on the shared pool.
+ *
+ * @param A Future of the matrix to transpose.
+ * @return A future holding A^T.
+ */
+template<typename T>
+MatrixFuture<T> transposeAsync(const MatrixFuture<T>& A) {
+    MatrixFuture<T> result;
+    A.whenReady([=]() {
+        if (A.state->error) {
+            result.complete(nullptr, A.state->error);
+            return;
+        }
+        std::shared_ptr<const Matrix<T>> source = A.state->value;
+        std::shared_ptr<Matrix<T>> transposed;
+        try {
+            transposed = std::make_shared<Matrix<T>>(
+                source->cols, source->rows
+            );
+        } catch (...) {
+            result.complete(nullptr, std::current_exception());
+            return;
+        }
+        size_t blockSize = 256;
+        size_t blockCols = (source->cols + blockSize - 1) / blockSize;
+        size_t blockCount =
+            (source->rows + blockSize - 1) / blockSize * blockCols;
+        result.runBlocks(blockCount, [=](size_t b) {
+            source->transposeBlock(
+                b / blockCols * blockSize, b % blockCols * blockSize,
+                blockSize, *transposed
+            );
+        }, transposed);
+    });
+    return result;
+}
+
+/**
+ * Asynchronously transposes a matrix. The operand is copied in O(1) by
+ * sharing its storage, so it may be modified or destroyed while the
+ * operation runs.
+ *
+ * @param A The matrix to transpose.
+ * @return A future holding A^T.
+ */
+template<typename T>
+MatrixFuture<T> transposeAsync(const Matrix<T>& A) {
+    return transposeAsync(MatrixFuture<T>(A));
+}
+
+#endif // MATRIXASYNC_H
@@ -1,22 +1,93 @@
 #ifndef MATRIXLIB_H
 #define MATRIXLIB_H
 
+#include "ThreadPool.h"
+#include "ContentHash.h"
+#include "MatrixWriter.h"
+
 #include <vector>
 #include <string>
-#include <future>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+#include <atomic>
+#include <cstdint>
 
-#include <iomanip>
-#include <numeric>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
 
-#include <sstream>
 #include <iostream>
 
+/**
+ * Operation applied to an operand of multiply().
+ *
+ * None uses the operand as is, Transpose uses its transpose.
+ */
+enum class Op { None, Transpose };
+
+/**
+ * Strategy used by Matrix<T>::qr().
+ *
+ * Auto picks TSQR for tall-skinny inputs and the blocked algorithm otherwise.
+ */
+enum class QRMode { Auto, Blocked, TSQR };
+
+/**
+ * Selects which symmetric product Matrix<T>::gram() computes.
+ *
+ * AAT computes A * A^T, ATA computes A^T * A.
+ */
+enum class GramForm { AAT, ATA };
+
+/**
+ * Identifies the lower or upper triangle of a square matrix.
+ */
+enum class Triangle { Lower, Upper };
+
+/**
+ * Type in which the multiplication kernels accumulate sums of products of
+ * T. Narrow types accumulate in a wider type so that long inner products
+ * do not overflow or lose precision before the final conversion to T:
+ * integral types narrower than 64 bits in long long or unsigned long long,
+ * and float in double. Specialize to select another accumulator.
+ */
+template<typename T>
+struct Accumulator {
+    typedef typename std::conditional<
+        std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+            sizeof(T) < sizeof(long long),
+        typename std::conditional<
+            std::is_signed<T>::value, long long, unsigned long long
+        >::type,
+        T
+    >::type type;
+};
+
+template<>
+struct Accumulator<float> { typedef double type; };
+
+template<typename T>
+class MatrixFuture;
+
 /**
  * Matrix Library
  *
  * This header-only library provides a template-based implementation of a 
  * matrix class.
  *
+ * Copies of a matrix share its element storage, so copying, passing by
+ * value and storing matrices in containers are O(1). The storage is
+ * reference counted and copied lazily when a matrix that shares it is
+ * modified through operator(), raw() or setSubmatrix(); const operations
+ * never copy it. A pointer or reference obtained from a mutable accessor
+ * writes to storage that later copies will share, so finish writing through
+ * it before copying the matrix.
+ *
+ * Dimensions and indices are size_t, so a matrix may hold more than 2^31
+ * elements. Products are accumulated in Accumulator<T>::type.
+ *
  * Usage example:
  * Matrix<int> A = {{1, 2}, {3, 4}};
  * Matrix<int> B = {{5, 6}, {7, 8}};
@@ -26,8 +97,29 @@
 template<typename T>
 class Matrix {
 private:
-    int rows, cols;
-    std::vector<T> data;
+    /**
+     * Element storage shared by the copies of a matrix, with the cached
+     * result of contentHash(), meaningful only while hashValid is set.
+     */
+    struct Storage {
+        std::vector<T> values;
+        std::atomic<uint64_t> hash;
+        std::atomic<bool> hashValid;
+
+        explicit Storage(std::vector<T> values) :
+            values(std::move(values)), hash(0), hashValid(false) {}
+    };
+
+    size_t rows, cols;
+    std::shared_ptr<Storage> storage;
+
+    // Asynchronous operations schedule the block helpers directly
+    template<typename U>
+    friend MatrixFuture<U> multiplyAsync(
+        const MatrixFuture<U>& A, Op opA, const MatrixFuture<U>& B, Op opB
+    );
+    template<typename U>
+    friend MatrixFuture<U> transposeAsync(const MatrixFuture<U>& A);
 
 public:
     /* ********************************************************************* */
@@ -40,8 +132,9 @@ public:
      * @param rows Number of rows in the matrix.
      * @param cols Number of columns in the matrix.
      */
-    Matrix(int rows, int cols) : 
-        rows(rows), cols(cols), data(rows * cols, 0) {}
+    Matrix(size_t rows, size_t cols) : 
+        rows(rows), cols(cols), 
+        storage(std::make_shared<Storage>(std::vector<T>(rows * cols, 0))) {}
 
     /**
      * Constructs a matrix from a nested initializer list.
@@ -51,10 +144,10 @@ public:
     Matrix(std::initializer_list<std::initializer_list<T>> init) : 
         rows(init.size()), 
         cols(init.begin()->size()),
-        data(rows * cols) {
-        auto it = data.begin();
+        storage(std::make_shared<Storage>(std::vector<T>(rows * cols))) {
+        auto it = storage->values.begin();
         for (const auto& row : init) {
-            if (row.size() != static_cast<size_t>(cols)) {
+            if (row.size() != cols) {
                 throw std::invalid_argument(
                     "All rows must have the same number of columns."
                 );
@@ -63,6 +156,53 @@ public:
         }
     }
 
+    /**
+     * Constructs a copy of another matrix in O(1) by sharing its storage.
+     * 
+     * @param other The matrix to copy.
+     */
+    Matrix(const Matrix<T>& other) = default;
+
+    /**
+     * Constructs a matrix by taking over the storage of another matrix,
+     * which is left empty.
+     * 
+     * @param other The matrix to move from.
+     */
+    Matrix(Matrix<T>&& other) noexcept : 
+        rows(other.rows), cols(other.cols), 
+        storage(std::move(other.storage)) {
+        other.rows = other.cols = 0;
+        other.storage = emptyStorage();
+    }
+
+    /**
+     * Makes this matrix a copy of another matrix in O(1) by sharing its
+     * storage.
+     * 
+     * @param other The matrix to copy.
+     * @return Reference to this matrix.
+     */
+    Matrix<T>& operator=(const Matrix<T>& other) = default;
+
+    /**
+     * Replaces the contents of this matrix with the storage of another
+     * matrix, which is left empty.
+     * 
+     * @param other The matrix to move from.
+     * @return Reference to this matrix.
+     */
+    Matrix<T>& operator=(Matrix<T>&& other) noexcept {
+        if (this != &other) {
+            rows = other.rows;
+            cols = other.cols;
+            storage = std::move(other.storage);
+            other.rows = other.cols = 0;
+            other.storage = emptyStorage();
+        }
+        return *this;
+    }
+
     /* ********************************************************************* */
     /* ***************************** Accessors ***************************** */
     /* ********************************************************************* */
@@ -72,7 +212,7 @@ public:
      * 
      * @return Integer count of rows.
      */
-    int getRows() const { 
+    size_t getRows() const { 
         return rows; 
     }
 
@@ -81,24 +221,117 @@ public:
      * 
      * @return Integer count of columns.
      */
-    int getCols() const { 
+    size_t getCols() const { 
         return cols; 
     }
 
+    /**
+     * Returns the row-major element storage, for bulk reads and writes.
+     * Element (row, col) is at offset row * getCols() + col. Detaches shared
+     * storage and invalidates the cached content hash.
+     * 
+     * @return Pointer to the first element.
+     */
+    T* raw() {
+        detach();
+        return storage->values.data();
+    }
+
+    /**
+     * Returns the row-major element storage, for bulk reads.
+     * 
+     * @return Const pointer to the first element.
+     */
+    const T* raw() const {
+        return storage->values.data();
+    }
+
+    /**
+     * Returns a 64-bit hash of the dimensions and elements, computed in
+     * parallel for large matrices. The hash is cached until the matrix is
+     * next modified through operator(), raw() or setSubmatrix(), so hashing
+     * an unchanged matrix again is free. Writes through a reference or
+     * pointer obtained before the last call are not detected.
+     * 
+     * Elements are hashed by their object representation, so values that
+     * compare equal with different bytes (0.0 and -0.0) hash differently.
+     * 
+     * @return The content hash.
+     */
+    uint64_t contentHash() const {
+        if (storage->hashValid.load(std::memory_order_acquire))
+            return storage->hash.load(std::memory_order_relaxed);
+        uint64_t dimensions = static_cast<uint64_t>(rows) * hashing::PRIME1 ^
+                              static_cast<uint64_t>(cols);
+        uint64_t value = ::contentHash(
+            raw(), storage->values.size() * sizeof(T), dimensions
+        );
+        storage->hash.store(value, std::memory_order_relaxed);
+        storage->hashValid.store(true, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * Copies a rectangular region of the matrix into a new matrix.
+     * 
+     * @param row Row index of the top-left corner of the region.
+     * @param col Column index of the top-left corner of the region.
+     * @param numRows Number of rows in the region.
+     * @param numCols Number of columns in the region.
+     * @return A new matrix holding a copy of the region.
+     */
+    Matrix<T> submatrix(
+        size_t row, size_t col, size_t numRows, size_t numCols
+    ) const {
+        if (row > rows || numRows > rows - row ||
+            col > cols || numCols > cols - col) {
+            throw std::out_of_range("Submatrix exceeds matrix bounds.");
+        }
+        Matrix<T> result(numRows, numCols);
+        T* out = result.raw();
+        for (size_t i = 0; i < numRows; ++i) {
+            const T* src = raw() + (row + i) * cols + col;
+            std::copy(src, src + numCols, out + i * numCols);
+        }
+        return result;
+    }
+
+    /**
+     * Overwrites a rectangular region of the matrix with another matrix.
+     * 
+     * @param row Row index where the top-left corner of block is placed.
+     * @param col Column index where the top-left corner of block is placed.
+     * @param block The matrix to copy into this matrix.
+     */
+    void setSubmatrix(size_t row, size_t col, const Matrix<T>& block) {
+        if (row > rows || block.rows > rows - row ||
+            col > cols || block.cols > cols - col) {
+            throw std::out_of_range("Submatrix exceeds matrix bounds.");
+        }
+        const T* in = block.raw();
+        T* out = raw();
+        for (size_t i = 0; i < block.rows; ++i) {
+            const T* src = in + i * block.cols;
+            std::copy(src, src + block.cols, out + (row + i) * cols + col);
+        }
+    }
+
     /* ********************************************************************* */
     /* ************************ Operator Overloads ************************* */
     /* ********************************************************************* */
 
     /**
      * Accesses the element at the specified row and column of the matrix.
-     * Provides modifiable access.
+     * Provides modifiable access, detaching shared storage and invalidating
+     * the cached content hash.
      * 
      * @param row The zero-based index of the row.
      * @param col The zero-based index of the column.
      * @return Reference to the matrix element.
      */
-    T& operator()(int row, int col) {
-        return data[row * cols + col];
+    T& operator()(size_t row, size_t col) {
+        detach();
+        return storage->values[row * cols + col];
     }
 
     /**
@@ -109,8 +342,8 @@ public:
      * @param col The zero-based index of the column.
      * @return Const reference to the matrix element.
      */
-    const T& operator()(int row, int col) const {
-        return data[row * cols + col];
+    const T& operator()(size_t row, size_t col) const {
+        return storage->values[row * cols + col];
     }    
 
     /**
@@ -121,7 +354,11 @@ public:
      *         elements are equal; false otherwise.
      */
     bool operator==(const Matrix<T>& rhs) const {
-        return rows == rhs.rows && cols == rhs.cols && data == rhs.data;
+        if (rows != rhs.rows || cols != rhs.cols) return false;
+        // Shared storage is equal to itself unless it may hold NaNs
+        if (storage == rhs.storage && !std::is_floating_point<T>::value)
+            return true;
+        return storage->values == rhs.storage->values;
     }
 
     /**
@@ -139,6 +376,44 @@ public:
     /* ************************* Matrix Operations ************************* */
     /* ********************************************************************* */
 
+    /**
+     * Adds another matrix to this matrix element-wise.
+     * 
+     * @param other The matrix to add.
+     * @return A new matrix representing the sum.
+     */
+    Matrix<T> operator+(const Matrix<T>& other) const {
+        if (rows != other.rows || cols != other.cols) 
+            throw std::invalid_argument(
+                "Incompatible dimensions for addition."
+            );
+        Matrix<T> result(*this);
+        T* out = result.raw();
+        const T* in = other.raw();
+        for (size_t i = 0; i < storage->values.size(); ++i)
+            out[i] += in[i];
+        return result;
+    }
+
+    /**
+     * Subtracts another matrix from this matrix element-wise.
+     * 
+     * @param other The matrix to subtract.
+     * @return A new matrix representing the difference.
+     */
+    Matrix<T> operator-(const Matrix<T>& other) const {
+        if (rows != other.rows || cols != other.cols) 
+            throw std::invalid_argument(
+                "Incompatible dimensions for subtraction."
+            );
+        Matrix<T> result(*this);
+        T* out = result.raw();
+        const T* in = other.raw();
+        for (size_t i = 0; i < storage->values.size(); ++i)
+            out[i] -= in[i];
+        return result;
+    }
+
     /**
      * Multiplies this matrix by another matrix.
      * 
@@ -146,29 +421,38 @@ public:
      * @return A new matrix representing the result of the multiplication.
      */
     Matrix<T> operator*(const Matrix<T>& other) const {
-        // Validate matrix dimensions
-        if (cols != other.rows) throw std::invalid_argument(
-            "Incompatible dimensions for multiplication."
-        );
-        // Determine the number of rows and columns for the resulting matrix
-        Matrix<T> result(rows, other.cols);
-        // Launch asynchronous tasks for each block of the resulting matrix
-        int blockSize = 128;
-        std::vector<std::future<void>> futures;
-        for (int i = 0; i < rows; i += blockSize) {
-            for (int j = 0; j < other.cols; j += blockSize) {
-                futures.push_back(std::async(
-                    std::launch::async,
-                    &Matrix::multiplyBlock,
-                    this, i, j, blockSize,
-                    std::cref(other),
-                    std::ref(result)
-                ));
-            }
-        }
-        // Wait for all asynchronous tasks to complete
-        for (auto& future : futures)
-            future.get();
+        return multiply(*this, Op::None, other, Op::None);
+    }
+
+    /**
+     * Multiplies op(A) by op(B), where each op either leaves its operand 
+     * unchanged or transposes it. Transposition is absorbed into the 
+     * packing of each block, so no transposed copy is ever materialized.
+     * 
+     * Usage example:
+     * auto C = multiply(A, Op::Transpose, B, Op::None); // A^T * B
+     * 
+     * @param A The left-hand side matrix.
+     * @param opA The operation applied to A.
+     * @param B The right-hand side matrix.
+     * @param opB The operation applied to B.
+     * @return A new matrix representing op(A) * op(B).
+     */
+    friend Matrix<T> multiply(
+        const Matrix<T>& A, Op opA, const Matrix<T>& B, Op opB
+    ) {
+        Matrix<T> result = allocateProduct(A, opA, B, opB);
+        // Run a task on the shared pool for each block of the result
+        size_t blockSize = 128;
+        size_t blockCols = (result.cols + blockSize - 1) / blockSize;
+        size_t blockCount =
+            (result.rows + blockSize - 1) / blockSize * blockCols;
+        ThreadPool::instance().parallelFor(blockCount, [&](size_t b) {
+            multiplyBlock(
+                b / blockCols * blockSize, b % blockCols * blockSize, 
+                blockSize, A, opA, B, opB, result
+            );
+        });
         return result;
     }
     
@@ -179,25 +463,162 @@ public:
      */
     Matrix<T> transpose() const {
         Matrix<T> result(cols, rows);
-        // Loop over the matrix in blocks
-        int blockSize = 256;
-        std::vector<std::future<void>> futures;
-        for (int i = 0; i < rows; i += blockSize) {
-            for (int j = 0; j < cols; j += blockSize) {
-                futures.push_back(std::async(
-                    std::launch::async,
-                    [=, &result]() {
-                        transposeBlock(i, j, blockSize, result);
-                    }
-                ));
+        // Run a task on the shared pool for each block of the matrix
+        size_t blockSize = 256;
+        size_t blockCols = (cols + blockSize - 1) / blockSize;
+        size_t blockCount = (rows + blockSize - 1) / blockSize * blockCols;
+        ThreadPool::instance().parallelFor(blockCount, [&](size_t b) {
+            transposeBlock(
+                b / blockCols * blockSize, b % blockCols * blockSize, 
+                blockSize, result
+            );
+        });
+        return result;
+    }
+
+    /**
+     * Computes the symmetric rank-k product A * A^T or A^T * A of this 
+     * matrix without forming the transpose. Only the tiles of the requested
+     * triangle are computed (in parallel), roughly halving the work of the 
+     * equivalent general multiplication. Each task mirrors its own tile.
+     * 
+     * @param form Which of the two symmetric products to compute.
+     * @param triangle The triangle of the result that is computed.
+     * @param mirror Whether to copy the computed triangle into the other 
+     *               one. If false, the other triangle is zero, not a
+     *               mirror: the result is a triangular matrix, not the
+     *               symmetric product, and operator* or == treat it as such.
+     * @return A new square matrix holding the product, or only its
+     *         requested triangle if mirror is false.
+     */
+    Matrix<T> gram(
+        GramForm form = GramForm::AAT, 
+        Triangle triangle = Triangle::Lower, 
+        bool mirror = true
+    ) const {
+        size_t n = form == GramForm::AAT ? rows : cols;
+        Matrix<T> result(n, n);
+        // Collect the blocks in the triangle
+        size_t blockSize = 128;
+        std::vector<std::pair<size_t, size_t>> blocks;
+        for (size_t i = 0; i < n; i += blockSize) {
+            for (size_t j = 0; j < n; j += blockSize) {
+                if (triangle == Triangle::Lower ? j > i : j < i) continue;
+                blocks.push_back(std::make_pair(i, j));
             }
         }
-        // Wait for all asynchronous tasks to complete
-        for (auto& future : futures)
-            future.get();
+        // Run a task on the shared pool for each of them
+        ThreadPool::instance().parallelFor(
+            blocks.size(), [&](size_t b) {
+                gramBlock(
+                    blocks[b].first, blocks[b].second, blockSize, 
+                    form, triangle, result
+                );
+                if (mirror) {
+                    mirrorBlock(
+                        blocks[b].first, blocks[b].second, blockSize,
+                        triangle, result
+                    );
+                }
+            }
+        );
         return result;
     }
 
+    /* ********************************************************************* */
+    /* *************************** Factorizations ************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Computes the Cholesky factorization A = L * L^T of a symmetric 
+     * positive-definite matrix using a blocked right-looking algorithm.
+     * Only the lower triangle of this matrix is read. The trailing update 
+     * of each block step is performed with the parallel multiplication.
+     * 
+     * @param blockSize Width of the column panels factored at each step.
+     * @return The lower-triangular factor L.
+     * @throws std::invalid_argument If the matrix is not square.
+     * @throws std::domain_error If the matrix is not positive definite.
+     */
+    Matrix<T> cholesky(size_t blockSize = 128) const {
+        if (rows != cols) throw std::invalid_argument(
+            "Cholesky factorization requires a square matrix."
+        );
+        if (blockSize == 0) throw std::invalid_argument(
+            "Block size must be positive."
+        );
+        const size_t n = rows;
+        Matrix<T> L(*this);
+        // Detach once; the kernels below work on the unshared elements
+        T* l = L.raw();
+        for (size_t k = 0; k < n; k += blockSize) {
+            size_t kb = std::min(blockSize, n - k);
+            size_t below = n - k - kb;
+            // Factor the diagonal block
+            choleskyDiagonalBlock(l, n, k, kb);
+            // Solve for the panel below the diagonal block in parallel
+            size_t panelBlock = 128;
+            ThreadPool::instance().parallelFor(
+                (below + panelBlock - 1) / panelBlock, [&](size_t b) {
+                    size_t i = k + kb + b * panelBlock;
+                    choleskyPanelBlock(
+                        l, n, i, std::min(i + panelBlock, n), k, kb
+                    );
+                }
+            );
+            if (below == 0) break;
+            // Update the trailing submatrix: A22 -= L21 * L21^T
+            Matrix<T> L21 = L.submatrix(k + kb, k, below, kb);
+            const Matrix<T> update = L21.gram(
+                GramForm::AAT, Triangle::Lower, false
+            );
+            const T* u = update.raw();
+            for (size_t i = 0; i < below; ++i) {
+                T* row = l + (k + kb + i) * n + k + kb;
+                for (size_t j = 0; j <= i; ++j)
+                    row[j] -= u[i * below + j];
+            }
+        }
+        // Clear the (unreferenced) upper triangle
+        for (size_t i = 0; i < n; ++i)
+            std::fill(l + i * n + i + 1, l + (i + 1) * n, T(0));
+        return L;
+    }
+
+    /**
+     * Computes the thin QR factorization A = Q * R using Householder 
+     * reflections. The blocked algorithm accumulates each panel of 
+     * reflectors in compact WY form (I - V * T * V^T) so that the trailing 
+     * update and the formation of Q are performed with the parallel 
+     * multiplication. The TSQR algorithm splits a tall-skinny matrix into 
+     * row blocks, factors them concurrently and combines their R factors 
+     * in a reduction tree.
+     * 
+     * @param mode The factorization strategy to use.
+     * @param blockSize Number of reflectors accumulated per panel.
+     * @return A pair (Q, R) where Q is rows x k with orthonormal columns and
+     *         R is k x cols upper-triangular, with k = min(rows, cols).
+     * @throws std::invalid_argument If TSQR is requested for a matrix with 
+     *         more columns than rows.
+     */
+    std::pair<Matrix<T>, Matrix<T>> qr(
+        QRMode mode = QRMode::Auto, size_t blockSize = 64
+    ) const {
+        if (blockSize == 0) throw std::invalid_argument(
+            "Block size must be positive."
+        );
+        if (mode == QRMode::TSQR && rows < cols) throw std::invalid_argument(
+            "TSQR requires at least as many rows as columns."
+        );
+        if (mode == QRMode::Auto) {
+            bool tallSkinny = cols > 0 && rows >= 4096 && rows >= 8 * cols;
+            mode = tallSkinny ? QRMode::TSQR : QRMode::Blocked;
+        }
+        if (mode == QRMode::TSQR && cols > 0 && rows >= 2 * cols)
+            return tsqr(blockSize);
+        return blockedQR(blockSize);
+    }
+
     /* ********************************************************************* */
     /* *************************** Visualization *************************** */
     /* ********************************************************************* */
@@ -209,29 +630,12 @@ public:
      * @param color The color code to apply to the matrix.
      */
     void print(int indent = 0, const std::string& color = "\033[0m") const {
-        std::ostringstream stream;
-        // Add indentation to the beginning of each line
-        std::string padding(indent, ' ');
-        // Calculate the maximum width required for each column
-        std::vector<int> columnWidths = getColumnWidths();
-        // Generate string representation of matrix
-        int totalWidth = std::accumulate(
-            columnWidths.begin(), 
-            columnWidths.end(), 0
-        ) + cols;
-        const std::string resetColorCode = "\033[0m";
-        stream << color << padding << "┌" << std::string(totalWidth + 1, ' ') 
-               << "┐\n" << resetColorCode;
-        for (int i = 0; i < rows; ++i) {
-            stream << color << padding << "|";
-            for (int j = 0; j < cols; ++j)
-                stream << " " << std::setw(columnWidths[j]) << (*this)(i, j);
-            stream << " |\n" << resetColorCode;
-        }
-        stream << color << padding << "└" << std::string(totalWidth + 1, ' ') 
-               << "┘\n" << resetColorCode;
-        // Print string representation of matrix
-        std::cout << stream.str();
+        WriterOptions options;
+        // Six significant digits, like the default stream formatting
+        options.precision = 6;
+        options.indent = indent;
+        options.color = color;
+        writeMatrix(std::cout, *this, options);
     }
 
 private:
@@ -240,67 +644,435 @@ private:
     /* ********************************************************************* */
 
     /**
-     * Counts the number of digits in a given integer.
-     * 
-     * @param n The integer whose digits are to be counted.
-     * @return The number of digits in the integer.
+     * Prepares the storage for a write: copies it if other matrices share
+     * it and invalidates the cached content hash. A matrix whose storage is
+     * shared must not be first modified from several threads at once.
      */
-    int countDigits(int n) const {
-        n = std::abs(n);
-        if (n == 0) return 1;
-        int digits = 0;
-        while (n != 0) {
-            n /= 10;
-            digits++;
+    void detach() {
+        if (storage.use_count() > 1) {
+            storage = std::make_shared<Storage>(storage->values);
+        } else {
+            // use_count() is a relaxed load: order the reads made through
+            // copies that other threads have since destroyed before the
+            // writes that follow
+            std::atomic_thread_fence(std::memory_order_acquire);
         }
-        return digits;
+        // Only store when needed, to keep the line shared between readers
+        if (storage->hashValid.load(std::memory_order_relaxed))
+            storage->hashValid.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the storage of empty matrices, shared by all moved-from
+     * matrices so that moving never allocates.
+     */
+    static std::shared_ptr<Storage> emptyStorage() {
+        static const std::shared_ptr<Storage> empty =
+            std::make_shared<Storage>(std::vector<T>());
+        return empty;
     }
 
     /**
-     * Calculates the maximum width required for each matrix column.
+     * Validates the dimensions of op(A) * op(B) and allocates its result.
      * 
-     * @return A vector containing the maximum width for each column.
+     * @param A The left-hand side matrix.
+     * @param opA The operation applied to A.
+     * @param B The right-hand side matrix.
+     * @param opB The operation applied to B.
+     * @return A zero-initialized matrix with the dimensions of the product.
+     */
+    static Matrix<T> allocateProduct(
+        const Matrix<T>& A, Op opA, const Matrix<T>& B, Op opB
+    ) {
+        size_t inner = opA == Op::None ? A.cols : A.rows;
+        size_t otherInner = opB == Op::None ? B.rows : B.cols;
+        if (inner != otherInner) throw std::invalid_argument(
+            "Incompatible dimensions for multiplication."
+        );
+        return Matrix<T>(
+            opA == Op::None ? A.rows : A.cols, 
+            opB == Op::None ? B.cols : B.rows
+        );
+    }
+
+    /**
+     * Helper function to multiply a block of the matrix.
+     * Used in multithreaded multiplication algorithm. The block's rows of 
+     * op(A) and columns of op(B) are packed into contiguous buffers one 
+     * depth slice at a time, applying the requested transpositions, and 
+     * the block is summed in Accumulator<T>::type before being stored.
+     * 
+     * @param rowStart The starting row index for the block.
+     * @param colStart The starting column index for the block.
+     * @param blockSize The size of the block to process.
+     * @param A The left-hand side matrix.
+     * @param opA The operation applied to A.
+     * @param B The right-hand side matrix.
+     * @param opB The operation applied to B.
+     * @param result Reference to the resulting matrix where the block's 
+     *               results are stored.
      */
-    std::vector<int> getColumnWidths() const {
-        std::vector<int> columnWidths(cols, 0);
-        for (int j = 0; j < cols; ++j) {
-            for (int i = 0; i < rows; ++i) {
-                int element = (*this)(i, j);
-                int width = countDigits(element);
-                if (element < 0) width++; // Account for negative sign
-                columnWidths[j] = std::max(columnWidths[j], width);
+    static void multiplyBlock(
+        size_t rowStart, size_t colStart, size_t blockSize, 
+        const Matrix<T>& A, Op opA, const Matrix<T>& B, Op opB,
+        Matrix<T>& result
+    ) {
+        size_t endRow = std::min(rowStart + blockSize, result.rows);
+        size_t endCol = std::min(colStart + blockSize, result.cols);
+        size_t blockRows = endRow - rowStart, blockCols = endCol - colStart;
+        size_t inner = opA == Op::None ? A.cols : A.rows;
+        size_t depth = 256;
+        typedef typename Accumulator<T>::type Acc;
+        std::vector<Acc> packedA(blockRows * std::min(depth, inner));
+        std::vector<Acc> packedB(blockCols * std::min(depth, inner));
+        std::vector<Acc> sums(blockRows * blockCols, Acc(0));
+        for (size_t kk = 0; kk < inner; kk += depth) {
+            size_t kb = std::min(depth, inner - kk);
+            // Pack rows of op(A): packedA[i * kb + k] = op(A)(i, k)
+            if (opA == Op::None) {
+                for (size_t i = 0; i < blockRows; ++i)
+                    for (size_t k = 0; k < kb; ++k)
+                        packedA[i * kb + k] = A(rowStart + i, kk + k);
+            } else {
+                for (size_t k = 0; k < kb; ++k)
+                    for (size_t i = 0; i < blockRows; ++i)
+                        packedA[i * kb + k] = A(kk + k, rowStart + i);
+            }
+            // Pack columns of op(B): packedB[j * kb + k] = op(B)(k, j)
+            if (opB == Op::None) {
+                for (size_t k = 0; k < kb; ++k)
+                    for (size_t j = 0; j < blockCols; ++j)
+                        packedB[j * kb + k] = B(kk + k, colStart + j);
+            } else {
+                for (size_t j = 0; j < blockCols; ++j)
+                    for (size_t k = 0; k < kb; ++k)
+                        packedB[j * kb + k] = B(colStart + j, kk + k);
+            }
+            // Accumulate the slice's contribution into the block
+            for (size_t i = 0; i < blockRows; ++i) {
+                const Acc* rowA = &packedA[i * kb];
+                for (size_t j = 0; j < blockCols; ++j) {
+                    const Acc* colB = &packedB[j * kb];
+                    Acc sum = 0;
+                    for (size_t k = 0; k < kb; ++k)
+                        sum += rowA[k] * colB[k];
+                    sums[i * blockCols + j] += sum;
+                }
             }
         }
-        return columnWidths;
+        T* out = result.raw() + rowStart * result.cols + colStart;
+        for (size_t i = 0; i < blockRows; ++i)
+            for (size_t j = 0; j < blockCols; ++j)
+                out[i * result.cols + j] =
+                    static_cast<T>(sums[i * blockCols + j]);
     }
 
     /**
-     * Helper function to multiply a block of the matrix.
-     * Used in multithreaded multiplication algorithm.
+     * Helper function to compute a block of a symmetric product.
+     * Used in the multithreaded gram() algorithm. Elements of diagonal
+     * blocks outside the requested triangle are skipped.
      * 
      * @param rowStart The starting row index for the block.
      * @param colStart The starting column index for the block.
      * @param blockSize The size of the block to process.
-     * @param other The matrix to multiply with.
+     * @param form Which of the two symmetric products to compute.
+     * @param triangle The triangle of the result being computed.
      * @param result Reference to the resulting matrix where the block's 
      *               results are stored.
      */
-    void multiplyBlock(
-        int rowStart, int colStart, int blockSize, 
-        const Matrix<T>& other, Matrix<T>& result
+    void gramBlock(
+        size_t rowStart, size_t colStart, size_t blockSize, 
+        GramForm form, Triangle triangle, Matrix<T>& result
     ) const {
-        int endRow = std::min(rowStart + blockSize, rows);
-        int endCol = std::min(colStart + blockSize, other.getCols());
-        for (int i = rowStart; i < endRow; ++i) {
-            for (int j = colStart; j < endCol; ++j) {
-                T sum = 0;
-                for (int k = 0; k < cols; ++k)
-                    sum += (*this)(i, k) * other(k, j);
-                result(i, j) = sum;
+        size_t n = result.rows;
+        size_t endRow = std::min(rowStart + blockSize, n);
+        size_t endCol = std::min(colStart + blockSize, n);
+        bool lower = triangle == Triangle::Lower;
+        typedef typename Accumulator<T>::type Acc;
+        T* c = result.raw();
+        if (form == GramForm::AAT) {
+            // C(i, j) = A(i, :) . A(j, :), both rows are contiguous
+            for (size_t i = rowStart; i < endRow; ++i) {
+                size_t first = lower ? colStart : std::max(colStart, i);
+                size_t last = lower ? std::min(endCol, i + 1) : endCol;
+                for (size_t j = first; j < last; ++j) {
+                    Acc sum = 0;
+                    const T* rowI = raw() + i * cols;
+                    const T* rowJ = raw() + j * cols;
+                    for (size_t k = 0; k < cols; ++k)
+                        sum += static_cast<Acc>(rowI[k]) * rowJ[k];
+                    c[i * n + j] = static_cast<T>(sum);
+                }
+            }
+        } else {
+            // C(i, :) += A(k, i) * A(k, :), streaming over the rows of A
+            size_t blockCols = endCol - colStart;
+            std::vector<Acc> sums((endRow - rowStart) * blockCols, Acc(0));
+            for (size_t k = 0; k < rows; ++k) {
+                const T* row = raw() + k * cols;
+                for (size_t i = rowStart; i < endRow; ++i) {
+                    size_t first = lower ? colStart : std::max(colStart, i);
+                    size_t last = lower ? std::min(endCol, i + 1) : endCol;
+                    Acc scale = row[i];
+                    Acc* out = sums.data() + (i - rowStart) * blockCols;
+                    for (size_t j = first; j < last; ++j)
+                        out[j - colStart] += scale * row[j];
+                }
+            }
+            for (size_t i = rowStart; i < endRow; ++i) {
+                size_t first = lower ? colStart : std::max(colStart, i);
+                size_t last = lower ? std::min(endCol, i + 1) : endCol;
+                for (size_t j = first; j < last; ++j)
+                    c[i * n + j] = static_cast<T>(
+                        sums[(i - rowStart) * blockCols + j - colStart]
+                    );
+            }
+        }
+    }
+
+    /**
+     * Copies a block of the computed triangle of a symmetric product into
+     * the transposed block of the other triangle. Only the task that
+     * computed a block writes its mirror, so no two tasks write the same
+     * element.
+     * 
+     * @param rowStart The starting row index for the block.
+     * @param colStart The starting column index for the block.
+     * @param blockSize The size of the block to mirror.
+     * @param triangle The triangle of the result that was computed.
+     * @param result Reference to the square matrix being mirrored.
+     */
+    static void mirrorBlock(
+        size_t rowStart, size_t colStart, size_t blockSize, 
+        Triangle triangle, Matrix<T>& result
+    ) {
+        size_t n = result.rows;
+        size_t endRow = std::min(rowStart + blockSize, n);
+        size_t endCol = std::min(colStart + blockSize, n);
+        bool lower = triangle == Triangle::Lower;
+        T* c = result.raw();
+        for (size_t i = rowStart; i < endRow; ++i) {
+            size_t first = lower ? colStart : std::max(colStart, i + 1);
+            size_t last = lower ? std::min(endCol, i) : endCol;
+            for (size_t j = first; j < last; ++j)
+                c[j * n + i] = c[i * n + j];
+        }
+    }
+
+    /**
+     * Factors the diagonal block starting at (k, k) in place with the 
+     * unblocked Cholesky algorithm. Updates from previous panels must 
+     * already have been applied.
+     * 
+     * @param a Elements of the n x n matrix being factored.
+     * @param n Number of rows and columns of the matrix.
+     * @param k Index of the first row and column of the diagonal block.
+     * @param kb Size of the diagonal block.
+     */
+    static void choleskyDiagonalBlock(T* a, size_t n, size_t k, size_t kb) {
+        for (size_t j = k; j < k + kb; ++j) {
+            T* rowJ = a + j * n;
+            T diagonal = rowJ[j];
+            for (size_t p = k; p < j; ++p)
+                diagonal -= rowJ[p] * rowJ[p];
+            if (!(diagonal > 0)) throw std::domain_error(
+                "Matrix is not positive definite."
+            );
+            rowJ[j] = std::sqrt(diagonal);
+            for (size_t i = j + 1; i < k + kb; ++i) {
+                T* rowI = a + i * n;
+                T sum = rowI[j];
+                for (size_t p = k; p < j; ++p)
+                    sum -= rowI[p] * rowJ[p];
+                rowI[j] = sum / rowJ[j];
+            }
+        }
+    }
+
+    /**
+     * Helper function to solve a block of rows of a Cholesky panel against
+     * the factored diagonal block (L21 = A21 * L11^-T).
+     * Used in the blocked Cholesky factorization.
+     * 
+     * @param a Elements of the n x n matrix being factored.
+     * @param n Number of rows and columns of the matrix.
+     * @param rowStart First row of the block.
+     * @param rowEnd One past the last row of the block.
+     * @param k Index of the first column of the panel.
+     * @param kb Width of the panel.
+     */
+    static void choleskyPanelBlock(
+        T* a, size_t n, size_t rowStart, size_t rowEnd, size_t k, size_t kb
+    ) {
+        for (size_t i = rowStart; i < rowEnd; ++i) {
+            T* rowI = a + i * n;
+            for (size_t j = k; j < k + kb; ++j) {
+                const T* rowJ = a + j * n;
+                T sum = rowI[j];
+                for (size_t p = k; p < j; ++p)
+                    sum -= rowI[p] * rowJ[p];
+                rowI[j] = sum / rowJ[j];
             }
         }
     }
 
+    /**
+     * Computes the thin QR factorization with compact WY blocked Householder
+     * reflections.
+     * 
+     * @param blockSize Number of reflectors accumulated per panel.
+     * @return A pair (Q, R) as described in qr().
+     */
+    std::pair<Matrix<T>, Matrix<T>> blockedQR(size_t blockSize) const {
+        const size_t m = rows, n = cols, k = std::min(rows, cols);
+        Matrix<T> A(*this);
+        // Detach once; the panel kernels work on the unshared elements
+        T* a = A.raw();
+        std::vector<Matrix<T>> reflectors, factors;
+        for (size_t j0 = 0; j0 < k; j0 += blockSize) {
+            size_t jb = std::min(blockSize, k - j0);
+            size_t panelRows = m - j0;
+            Matrix<T> V(panelRows, jb);
+            Matrix<T> Tf(jb, jb);
+            T* v = V.raw();
+            T* t = Tf.raw();
+            // Factor the panel with unblocked Householder reflections
+            for (size_t c = 0; c < jb; ++c) {
+                size_t j = j0 + c;
+                T tau = householder(a, m, n, j, j);
+                v[c * jb + c] = 1;
+                for (size_t i = j + 1; i < m; ++i) {
+                    v[(i - j0) * jb + c] = a[i * n + j];
+                    a[i * n + j] = 0;
+                }
+                // Apply the reflector to the remaining panel columns
+                for (size_t cc = j + 1; cc < j0 + jb; ++cc) {
+                    T w = a[j * n + cc];
+                    for (size_t i = j + 1; i < m; ++i)
+                        w += v[(i - j0) * jb + c] * a[i * n + cc];
+                    w *= tau;
+                    a[j * n + cc] -= w;
+                    for (size_t i = j + 1; i < m; ++i)
+                        a[i * n + cc] -= w * v[(i - j0) * jb + c];
+                }
+                // Extend the triangular factor: T(0:c, c) = -tau T V^T v
+                t[c * jb + c] = tau;
+                for (size_t r = 0; r < c; ++r) {
+                    T dot = 0;
+                    for (size_t i = c; i < panelRows; ++i)
+                        dot += v[i * jb + r] * v[i * jb + c];
+                    t[r * jb + c] = -tau * dot;
+                }
+                for (size_t r = 0; r < c; ++r) {
+                    T sum = 0;
+                    for (size_t p = r; p < c; ++p)
+                        sum += t[r * jb + p] * t[p * jb + c];
+                    t[r * jb + c] = sum;
+                }
+            }
+            // Apply the block reflector to the trailing columns:
+            // C -= V * (T^T * (V^T * C))
+            size_t trailing = n - j0 - jb;
+            if (trailing > 0) {
+                Matrix<T> C = A.submatrix(j0, j0 + jb, panelRows, trailing);
+                Matrix<T> W = multiply(
+                    Tf, Op::Transpose, 
+                    multiply(V, Op::Transpose, C, Op::None), Op::None
+                );
+                A.setSubmatrix(j0, j0 + jb, C - V * W);
+            }
+            reflectors.push_back(V);
+            factors.push_back(Tf);
+        }
+        // Form Q by applying the block reflectors to the identity in reverse
+        Matrix<T> Q(m, k);
+        for (size_t i = 0; i < k; ++i)
+            Q(i, i) = 1;
+        for (size_t b = reflectors.size(); b-- > 0;) {
+            size_t j0 = b * blockSize;
+            const Matrix<T>& V = reflectors[b];
+            Matrix<T> C = Q.submatrix(j0, j0, m - j0, k - j0);
+            Matrix<T> W = factors[b] * multiply(
+                V, Op::Transpose, C, Op::None
+            );
+            Q.setSubmatrix(j0, j0, C - V * W);
+        }
+        return std::make_pair(Q, A.submatrix(0, 0, k, n));
+    }
+
+    /**
+     * Computes the thin QR factorization of a tall-skinny matrix with the 
+     * TSQR algorithm. Row blocks are factored concurrently and their stacked
+     * R factors are factored again, recursing while the stack stays tall.
+     * 
+     * @param blockSize Number of reflectors accumulated per panel.
+     * @return A pair (Q, R) as described in qr().
+     */
+    std::pair<Matrix<T>, Matrix<T>> tsqr(size_t blockSize) const {
+        const size_t n = cols;
+        size_t leaves = std::max<size_t>(
+            2, std::min<size_t>(ThreadPool::instance().size(), rows / n)
+        );
+        std::vector<size_t> offsets;
+        for (size_t b = 0; b <= leaves; ++b)
+            offsets.push_back(rows * b / leaves);
+        // Factor each row block concurrently
+        std::vector<Matrix<T>> leafQ(leaves, Matrix<T>(0, 0));
+        Matrix<T> stacked(leaves * n, n);
+        ThreadPool::instance().parallelFor(leaves, [&](size_t b) {
+            Matrix<T> leaf = submatrix(
+                offsets[b], 0, offsets[b + 1] - offsets[b], n
+            );
+            std::pair<Matrix<T>, Matrix<T>> leafQR = leaf.blockedQR(blockSize);
+            leafQ[b] = leafQR.first;
+            stacked.setSubmatrix(b * n, 0, leafQR.second);
+        });
+        // Combine the leaf R factors (recursing up the reduction tree)
+        std::pair<Matrix<T>, Matrix<T>> top = stacked.qr(
+            QRMode::Auto, blockSize
+        );
+        // Q = diag(Q_0, ..., Q_p) * Q_top
+        Matrix<T> Q(rows, n);
+        for (size_t b = 0; b < leaves; ++b) {
+            Q.setSubmatrix(
+                offsets[b], 0, 
+                leafQ[b] * top.first.submatrix(b * n, 0, n, n)
+            );
+        }
+        return std::make_pair(Q, top.second);
+    }
+
+    /**
+     * Computes the Householder reflector that annihilates the entries below
+     * (row, col) in column col. On return (row, col) holds beta and the 
+     * entries below hold the reflector vector v (with implicit v[0] = 1), 
+     * such that (I - tau * v * v^T) * x = beta * e_1.
+     * 
+     * @param a Elements of the matrix being factored.
+     * @param rows Number of rows of the matrix.
+     * @param cols Number of columns of the matrix.
+     * @param row Row index of the pivot element.
+     * @param col Column index of the pivot element.
+     * @return The scalar factor tau (zero if no reflection is needed).
+     */
+    static T householder(
+        T* a, size_t rows, size_t cols, size_t row, size_t col
+    ) {
+        T alpha = a[row * cols + col];
+        T tailNorm = 0;
+        for (size_t i = row + 1; i < rows; ++i)
+            tailNorm += a[i * cols + col] * a[i * cols + col];
+        if (tailNorm == 0) return 0;
+        T norm = std::sqrt(alpha * alpha + tailNorm);
+        T beta = alpha >= 0 ? -norm : norm;
+        T tau = (beta - alpha) / beta;
+        T scale = 1 / (alpha - beta);
+        for (size_t i = row + 1; i < rows; ++i)
+            a[i * cols + col] *= scale;
+        a[row * cols + col] = beta;
+        return tau;
+    }
+
     /**
      * Helper function to transpose a block of the matrix. 
      * Used in multithreaded transposition algorithm.
@@ -312,15 +1084,17 @@ private:
      * @param blockSize Size of the block to transpose.
      */
     void transposeBlock(
-        int row, int col, 
-        int blockSize, 
+        size_t row, size_t col, 
+        size_t blockSize, 
         Matrix<T>& result
     ) const {
-        int blockRowEnd = std::min(row + blockSize, rows);
-        int blockColEnd = std::min(col + blockSize, cols);
-        for (int i = row; i < blockRowEnd; ++i) {
-            for (int j = col; j < blockColEnd; ++j) {
-                result(j, i) = (*this)(i, j);
+        size_t blockRowEnd = std::min(row + blockSize, rows);
+        size_t blockColEnd = std::min(col + blockSize, cols);
+        const T* in = raw();
+        T* out = result.raw();
+        for (size_t i = row; i < blockRowEnd; ++i) {
+            for (size_t j = col; j < blockColEnd; ++j) {
+                out[j * rows + i] = in[i * cols + j];
             }
         }
     }
@@ -0,0 +1,798 @@
+#ifndef MATRIXREADER_H
+#define MATRIXREADER_H
+
+#include "MatrixLib.h"
+#include "SparseMatrix.h"
+#include "ThreadPool.h"
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <utility>
+#include <type_traits>
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Matrix Readers
+ *
+ * Loaders for CSV/TSV and MatrixMarket (.mtx) text files. The file is
+ * memory-mapped and split at line boundaries into chunks that are counted
+ * and then parsed in parallel on the shared ThreadPool. Dense values are
+ * written directly into the pre-sized result; coordinate entries are
+ * collected per chunk and assembled row by row, and entries listed more
+ * than once for the same position are summed.
+ *
+ * Usage example:
+ * Matrix<double> A = readCSV<double>("A.csv");
+ * Matrix<double> B = readMatrixMarket<double>("B.mtx");
+ * SparseMatrix<double> S = readMatrixMarketSparse<double>("S.mtx");
+ */
+
+/**
+ * A read-only memory mapping of a whole file.
+ */
+class MappedFile {
+private:
+    const char* contents;
+    size_t length;
+
+public:
+    /**
+     * Maps a file into memory.
+     *
+     * @param path The path of the file to map.
+     * @throws std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path) :
+        contents(nullptr), length(0) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error(
+            "Failed to open " + path + ": " + std::strerror(errno)
+        );
+        struct stat status;
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            throw std::runtime_error(
+                "Failed to stat " + path + ": " + std::strerror(errno)
+            );
+        }
+        length = static_cast<size_t>(status.st_size);
+        if (length > 0) {
+            void* mapping = ::mmap(
+                nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0
+            );
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error(
+                    "Failed to map " + path + ": " + std::strerror(errno)
+                );
+            }
+            // Chunks are read concurrently, not front to back
+            ::madvise(mapping, length, MADV_WILLNEED);
+            contents = static_cast<const char*>(mapping);
+        }
+        ::close(fd);
+    }
+
+    /**
+     * Unmaps the file.
+     */
+    ~MappedFile() {
+        if (contents) ::munmap(const_cast<char*>(contents), length);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Returns the first character of the file.
+     *
+     * @return Pointer to the start of the mapping.
+     */
+    const char* begin() const {
+        return contents;
+    }
+
+    /**
+     * Returns one past the last character of the file.
+     *
+     * @return Pointer to the end of the mapping.
+     */
+    const char* end() const {
+        return contents + length;
+    }
+};
+
+/* ************************************************************************* */
+/* *************************** Number Parsing ****************************** */
+/* ************************************************************************* */
+
+/**
+ * Finds the end of the numeric token starting at first: the first
+ * character that cannot be part of a number.
+ *
+ * @param first Start of the token.
+ * @param last End of the text.
+ * @return Pointer one past the token.
+ */
+inline const char* numberTokenEnd(const char* first, const char* last) {
+    static const char alphabet[] = "0123456789+-.eEinfatyINFATY";
+    while (first != last && *first != '\0' && std::strchr(alphabet, *first))
+        ++first;
+    return first;
+}
+
+/**
+ * Parses an integral token without allocating.
+ *
+ * @return true if the whole token is a valid integer that T can represent.
+ */
+template<typename T>
+bool parseNumber(
+    const char* first, const char* last, T& value, std::true_type
+) {
+    bool negative = false;
+    if (first != last && (*first == '-' || *first == '+'))
+        negative = *first++ == '-';
+    if (first == last) return false;
+    // Largest magnitude T can represent with the token's sign
+    unsigned long long limit =
+        static_cast<unsigned long long>(std::numeric_limits<T>::max());
+    if (negative) limit = std::is_signed<T>::value ? limit + 1 : 0;
+    unsigned long long magnitude = 0;
+    for (; first != last; ++first) {
+        if (*first < '0' || *first > '9') return false;
+        unsigned digit = static_cast<unsigned>(*first - '0');
+        if (digit > limit || magnitude > (limit - digit) / 10) return false;
+        magnitude = magnitude * 10 + digit;
+    }
+    // Negate in T so that the minimum value does not overflow
+    value = negative && magnitude != 0
+        ? static_cast<T>(-static_cast<T>(magnitude - 1) - 1)
+        : static_cast<T>(magnitude);
+    return true;
+}
+
+/**
+ * Parses a floating-point token without allocating. Decimal tokens with at
+ * most 19 significant digits and a small exponent are converted exactly
+ * with one double operation; other tokens fall back to strtod on a stack
+ * copy of the token.
+ *
+ * @return true if the whole token is a valid number.
+ */
+template<typename T>
+bool parseNumber(
+    const char* first, const char* last, T& value, std::false_type
+) {
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char* p = first;
+    bool negative = false;
+    if (p != last && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+    std::uint64_t mantissa = 0;
+    int significant = 0, exponent = 0, digits = 0;
+    for (; p != last && *p >= '0' && *p <= '9'; ++p, ++digits) {
+        if (significant < 19) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            if (mantissa != 0) ++significant;
+        } else {
+            ++exponent;
+            significant = 20;
+        }
+    }
+    if (p != last && *p == '.') {
+        for (++p; p != last && *p >= '0' && *p <= '9'; ++p, ++digits) {
+            if (significant < 19) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                if (mantissa != 0) ++significant;
+                --exponent;
+            } else {
+                significant = 20;
+            }
+        }
+    }
+    if (digits > 0 && p != last && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if (q != last && (*q == '-' || *q == '+'))
+            negativeExponent = *q++ == '-';
+        int magnitude = 0, parsed = 0;
+        for (; q != last && *q >= '0' && *q <= '9'; ++q, ++parsed)
+            magnitude = std::min(magnitude * 10 + (*q - '0'), 100000);
+        if (parsed > 0) {
+            exponent += negativeExponent ? -magnitude : magnitude;
+            p = q;
+        }
+    }
+    bool exact = std::is_same<T, double>::value
+        && significant <= 19 && mantissa <= (1ULL << 53)
+        && exponent >= -22 && exponent <= 22;
+    if (digits > 0 && p == last && exact) {
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0
+            ? result / powersOfTen[-exponent]
+            : result * powersOfTen[exponent];
+        value = static_cast<T>(negative ? -result : result);
+        return true;
+    }
+    // Slow path: copy the token to a terminated buffer for strtod
+    char buffer[128];
+    size_t length = static_cast<size_t>(last - first);
+    if (length == 0 || length >= sizeof(buffer)) return false;
+    std::memcpy(buffer, first, length);
+    buffer[length] = '\0';
+    char* end = nullptr;
+    if (std::is_same<T, float>::value)
+        value = static_cast<T>(std::strtof(buffer, &end));
+    else if (std::is_same<T, double>::value)
+        value = static_cast<T>(std::strtod(buffer, &end));
+    else
+        value = static_cast<T>(std::strtold(buffer, &end));
+    return end == buffer + length;
+}
+
+/**
+ * Parses the numeric token starting at first.
+ *
+ * @param first Start of the token.
+ * @param last End of the text.
+ * @param value Receives the parsed value.
+ * @return Pointer one past the token, or nullptr if it is not a number.
+ */
+template<typename T>
+const char* parseNumber(const char* first, const char* last, T& value) {
+    const char* end = numberTokenEnd(first, last);
+    bool valid = parseNumber(
+        first, end, value,
+        std::integral_constant<bool, std::is_integral<T>::value>()
+    );
+    return valid ? end : nullptr;
+}
+
+/* ************************************************************************* */
+/* *************************** Line Splitting ****************************** */
+/* ************************************************************************* */
+
+/**
+ * Returns the end of the line starting at first (its newline or last).
+ */
+inline const char* lineEnd(const char* first, const char* last) {
+    const void* newline = std::memchr(first, '\n', last - first);
+    return newline ? static_cast<const char*>(newline) : last;
+}
+
+/**
+ * Skips spaces, tabs and carriage returns.
+ */
+inline const char* skipBlanks(const char* first, const char* last) {
+    while (first != last && (*first == ' ' || *first == '\t' || *first == '\r'))
+        ++first;
+    return first;
+}
+
+/**
+ * Splits text into about the given number of chunks, each starting at the
+ * beginning of a line.
+ *
+ * @param first Start of the text.
+ * @param last End of the text.
+ * @param parts Desired number of chunks.
+ * @return parts + 1 boundaries; chunk c spans [bounds[c], bounds[c + 1]).
+ */
+inline std::vector<const char*> splitAtLines(
+    const char* first, const char* last, int parts
+) {
+    std::vector<const char*> bounds(1, first);
+    size_t size = static_cast<size_t>(last - first);
+    for (int c = 1; c < parts; ++c) {
+        const char* p = std::max(first + size * c / parts, bounds.back());
+        if (p != first && p != last && p[-1] != '\n') {
+            p = lineEnd(p, last);
+            if (p != last) ++p;
+        }
+        bounds.push_back(p);
+    }
+    bounds.push_back(last);
+    return bounds;
+}
+
+/**
+ * Chooses how many chunks to split text into: at least 64 KiB each, a few
+ * per worker thread.
+ */
+inline int chunkCountFor(const char* first, const char* last) {
+    size_t chunks = static_cast<size_t>(last - first) / (64 * 1024);
+    size_t maxChunks = static_cast<size_t>(4 * ThreadPool::instance().size());
+    return static_cast<int>(std::max<size_t>(1, std::min(chunks, maxChunks)));
+}
+
+/**
+ * Calls f(lineBegin, lineEnd) for every line of [first, last) that is
+ * neither blank nor a comment starting with the given character.
+ *
+ * @param comment Comment character, or '\0' if comments are not allowed.
+ */
+template<typename F>
+void forEachDataLine(
+    const char* first, const char* last, char comment, F f
+) {
+    while (first != last) {
+        const char* end = lineEnd(first, last);
+        const char* content = skipBlanks(first, end);
+        if (content != end && (comment == '\0' || *content != comment))
+            f(content, end);
+        first = end == last ? last : end + 1;
+    }
+}
+
+/**
+ * Counts the data lines of each chunk in parallel and returns the index of
+ * the first data line of each chunk, followed by the total count.
+ */
+inline std::vector<long long> countDataLines(
+    const std::vector<const char*>& bounds, char comment
+) {
+    int chunks = static_cast<int>(bounds.size()) - 1;
+    std::vector<long long> firstLine(chunks + 1, 0);
+    ThreadPool::instance().parallelFor(chunks, [&](int c) {
+        long long count = 0;
+        forEachDataLine(bounds[c], bounds[c + 1], comment,
+            [&count](const char*, const char*) { ++count; });
+        firstLine[c + 1] = count;
+    });
+    for (int c = 0; c < chunks; ++c)
+        firstLine[c + 1] += firstLine[c];
+    return firstLine;
+}
+
+/* ************************************************************************* */
+/* ****************************** CSV Reader ******************************* */
+/* ************************************************************************* */
+
+/**
+ * Reads a matrix from a delimited text file with one row per line.
+ * Blank lines are ignored.
+ *
+ * @param path The path of the file to read.
+ * @param delimiter The character separating values (',' for CSV, '\t'
+ *                  for TSV).
+ * @return A new matrix holding the file's values.
+ * @throws std::runtime_error If the file cannot be read, a value cannot be
+ *         parsed, or rows have different numbers of values.
+ */
+template<typename T>
+Matrix<T> readCSV(const std::string& path, char delimiter = ',') {
+    MappedFile file(path);
+    std::vector<const char*> bounds = splitAtLines(
+        file.begin(), file.end(), chunkCountFor(file.begin(), file.end())
+    );
+    int chunks = static_cast<int>(bounds.size()) - 1;
+    // Count the rows of each chunk to find where each chunk's rows start
+    std::vector<long long> firstRow = countDataLines(bounds, '\0');
+    size_t rows = static_cast<size_t>(firstRow.back());
+    // The first data line determines the number of columns
+    size_t cols = 0;
+    for (const char* p = file.begin(); rows > 0 && p != file.end();) {
+        const char* end = lineEnd(p, file.end());
+        const char* content = skipBlanks(p, end);
+        if (content != end) {
+            cols = 1 + static_cast<size_t>(
+                std::count(content, end, delimiter)
+            );
+            break;
+        }
+        p = end == file.end() ? end : end + 1;
+    }
+    // Parse each chunk's rows directly into the result
+    Matrix<T> result(rows, cols);
+    T* out = result.raw();
+    ThreadPool::instance().parallelFor(chunks, [&](int c) {
+        long long row = firstRow[c];
+        forEachDataLine(bounds[c], bounds[c + 1], '\0',
+            [&](const char* p, const char* last) {
+                // Blanks around values are ignored, unless they delimit them
+                auto skip = [&](const char* q) {
+                    while (q != last && *q != delimiter && 
+                           (*q == ' ' || *q == '\t' || *q == '\r'))
+                        ++q;
+                    return q;
+                };
+                T* values = out + row * cols;
+                size_t j = 0;
+                for (; j < cols; ++j) {
+                    if (j > 0) {
+                        if (p == last || *p != delimiter) break;
+                        ++p;
+                    }
+                    p = parseNumber(skip(p), last, values[j]);
+                    if (!p) throw std::runtime_error(
+                        "Malformed value in row " + std::to_string(row + 1)
+                        + " of " + path + "."
+                    );
+                    p = skip(p);
+                }
+                if (j != cols || p != last) throw std::runtime_error(
+                    "Row " + std::to_string(row + 1) + " of " + path
+                    + " does not have " + std::to_string(cols) + " values."
+                );
+                ++row;
+            });
+    });
+    return result;
+}
+
+/* ************************************************************************* */
+/* ************************** MatrixMarket Reader ************************** */
+/* ************************************************************************* */
+
+/**
+ * Symmetry declared in a MatrixMarket header.
+ */
+enum class MatrixMarketSymmetry { General, Symmetric, SkewSymmetric };
+
+/**
+ * The parsed banner and size line of a MatrixMarket file.
+ */
+struct MatrixMarketHeader {
+    bool coordinate;
+    bool pattern;
+    MatrixMarketSymmetry symmetry;
+    size_t rows, cols;
+    long long entries;
+    const char* data;
+};
+
+/**
+ * Parses the banner, comments and size line of a MatrixMarket file.
+ *
+ * @param file The mapped file.
+ * @param path The path of the file, for error messages.
+ * @return The parsed header; data points at the first entry line.
+ * @throws std::runtime_error If the header is malformed or unsupported.
+ */
+inline MatrixMarketHeader readMatrixMarketHeader(
+    const MappedFile& file, const std::string& path
+) {
+    const char* p = file.begin();
+    const char* last = file.end();
+    const char* end = lineEnd(p, last);
+    // Banner: %%MatrixMarket matrix <format> <field> <symmetry>
+    std::vector<std::string> words;
+    for (const char* q = p; q != end;) {
+        q = skipBlanks(q, end);
+        const char* wordEnd = q;
+        while (wordEnd != end && *wordEnd != ' ' && *wordEnd != '\t'
+               && *wordEnd != '\r')
+            ++wordEnd;
+        if (wordEnd != q) {
+            std::string word(q, wordEnd);
+            for (auto& ch : word)
+                ch = static_cast<char>(std::tolower(ch));
+            words.push_back(word);
+        }
+        q = wordEnd;
+    }
+    if (words.size() != 5 || words[0] != "%%matrixmarket" ||
+        words[1] != "matrix") {
+        throw std::runtime_error(path + " is not a MatrixMarket matrix.");
+    }
+    MatrixMarketHeader header;
+    if (words[2] != "coordinate" && words[2] != "array")
+        throw std::runtime_error("Unsupported format " + words[2] + ".");
+    header.coordinate = words[2] == "coordinate";
+    if (words[3] != "real" && words[3] != "double" &&
+        words[3] != "integer" && words[3] != "pattern") {
+        throw std::runtime_error("Unsupported field " + words[3] + ".");
+    }
+    header.pattern = words[3] == "pattern";
+    if (words[4] == "general")
+        header.symmetry = MatrixMarketSymmetry::General;
+    else if (words[4] == "symmetric" || words[4] == "hermitian")
+        header.symmetry = MatrixMarketSymmetry::Symmetric;
+    else if (words[4] == "skew-symmetric")
+        header.symmetry = MatrixMarketSymmetry::SkewSymmetric;
+    else
+        throw std::runtime_error("Unsupported symmetry " + words[4] + ".");
+    // Skip comments up to the size line
+    p = end == last ? last : end + 1;
+    for (;;) {
+        if (p == last) throw std::runtime_error(
+            path + " has no size line."
+        );
+        end = lineEnd(p, last);
+        const char* content = skipBlanks(p, end);
+        p = end == last ? last : end + 1;
+        if (content == end || *content == '%') continue;
+        long long sizes[3] = {0, 0, -1};
+        int count = header.coordinate ? 3 : 2;
+        for (int k = 0; k < count && content; ++k)
+            content = parseNumber(skipBlanks(content, end), end, sizes[k]);
+        if (!content || skipBlanks(content, end) != end ||
+            sizes[0] < 0 || sizes[1] < 0) {
+            throw std::runtime_error(path + " has a malformed size line.");
+        }
+        header.rows = static_cast<size_t>(sizes[0]);
+        header.cols = static_cast<size_t>(sizes[1]);
+        header.entries = sizes[2];
+        break;
+    }
+    if (header.symmetry != MatrixMarketSymmetry::General &&
+        header.rows != header.cols) {
+        throw std::runtime_error(path + " is symmetric but not square.");
+    }
+    if (!header.coordinate) {
+        long long n = static_cast<long long>(header.rows);
+        if (header.symmetry == MatrixMarketSymmetry::General)
+            header.entries = n * static_cast<long long>(header.cols);
+        else if (header.symmetry == MatrixMarketSymmetry::Symmetric)
+            header.entries = n * (n + 1) / 2;
+        else
+            header.entries = n * (n - 1) / 2;
+    }
+    header.data = p;
+    return header;
+}
+
+/**
+ * Parses one coordinate entry line ("row col [value]").
+ *
+ * @return false if the line is malformed or out of bounds.
+ */
+template<typename T>
+bool parseCoordinateEntry(
+    const MatrixMarketHeader& header, const char* p, const char* last,
+    size_t& row, size_t& col, T& value
+) {
+    long long i = 0, j = 0;
+    p = parseNumber(p, last, i);
+    if (p) p = parseNumber(skipBlanks(p, last), last, j);
+    if (p && !header.pattern) p = parseNumber(skipBlanks(p, last), last, value);
+    if (header.pattern) value = 1;
+    if (!p || skipBlanks(p, last) != last) return false;
+    if (i < 1 || static_cast<size_t>(i) > header.rows ||
+        j < 1 || static_cast<size_t>(j) > header.cols) {
+        return false;
+    }
+    row = static_cast<size_t>(i - 1);
+    col = static_cast<size_t>(j - 1);
+    return true;
+}
+
+/**
+ * Parses the entries of a coordinate MatrixMarket file in parallel into
+ * per-chunk entry lists and assembles them row by row into CSR form.
+ * Symmetric and skew-symmetric files are expanded, and entries listed
+ * more than once for the same position are summed, so that a file that
+ * lists both (i, j) and (j, i) of a symmetric matrix contributes both.
+ *
+ * @param file The mapped file.
+ * @param header The header of the file, which must be in coordinate form.
+ * @param path The path of the file, for error messages.
+ * @return A new sparse matrix holding the file's entries.
+ * @throws std::runtime_error If the file is malformed.
+ */
+template<typename T>
+SparseMatrix<T> assembleCoordinateEntries(
+    const MappedFile& file, const MatrixMarketHeader& header,
+    const std::string& path
+) {
+    std::vector<const char*> bounds = splitAtLines(
+        header.data, file.end(), chunkCountFor(header.data, file.end())
+    );
+    int chunks = static_cast<int>(bounds.size()) - 1;
+    // Parse each chunk into its own entry lists
+    struct Entries {
+        std::vector<size_t> rows, cols;
+        std::vector<T> values;
+    };
+    std::vector<Entries> parsed(chunks);
+    bool skew = header.symmetry == MatrixMarketSymmetry::SkewSymmetric;
+    bool mirror = header.symmetry != MatrixMarketSymmetry::General;
+    ThreadPool::instance().parallelFor(chunks, [&](int c) {
+        Entries& entries = parsed[c];
+        forEachDataLine(bounds[c], bounds[c + 1], '%',
+            [&](const char* p, const char* last) {
+                size_t i = 0, j = 0;
+                T value = 0;
+                if (!parseCoordinateEntry(header, p, last, i, j, value))
+                    throw std::runtime_error(
+                        "Malformed entry in " + path + "."
+                    );
+                entries.rows.push_back(i);
+                entries.cols.push_back(j);
+                entries.values.push_back(value);
+                if (mirror && i != j) {
+                    entries.rows.push_back(j);
+                    entries.cols.push_back(i);
+                    entries.values.push_back(skew ? -value : value);
+                }
+            });
+    });
+    // Assemble the rows
+    long long declared = 0;
+    std::vector<size_t> offsets(header.rows + 1, 0);
+    for (const auto& entries : parsed) {
+        for (size_t k = 0; k < entries.rows.size(); ++k) {
+            ++offsets[entries.rows[k] + 1];
+            if (!mirror || entries.rows[k] >= entries.cols[k]) ++declared;
+        }
+    }
+    if (declared != header.entries) throw std::runtime_error(
+        path + " does not have the declared number of entries."
+    );
+    for (size_t i = 0; i < header.rows; ++i)
+        offsets[i + 1] += offsets[i];
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    std::vector<size_t> indices(offsets.back());
+    std::vector<T> values(offsets.back());
+    for (const auto& entries : parsed) {
+        for (size_t k = 0; k < entries.rows.size(); ++k) {
+            size_t position = cursor[entries.rows[k]]++;
+            indices[position] = entries.cols[k];
+            values[position] = entries.values[k];
+        }
+    }
+    // Sort each row by column and sum duplicates in parallel
+    std::vector<size_t> rowLengths(header.rows);
+    size_t blockSize = 1024;
+    ThreadPool::instance().parallelFor(
+        (header.rows + blockSize - 1) / blockSize, [&](size_t b) {
+            std::vector<std::pair<size_t, T>> row;
+            size_t end = std::min(header.rows, (b + 1) * blockSize);
+            for (size_t i = b * blockSize; i < end; ++i) {
+                row.clear();
+                for (size_t p = offsets[i]; p < offsets[i + 1]; ++p)
+                    row.push_back(std::make_pair(indices[p], values[p]));
+                std::stable_sort(row.begin(), row.end(),
+                    [](const std::pair<size_t, T>& a,
+                       const std::pair<size_t, T>& b) {
+                        return a.first < b.first;
+                    });
+                size_t length = 0;
+                for (size_t k = 0; k < row.size(); ++k) {
+                    size_t position = offsets[i] + length;
+                    if (length > 0 && indices[position - 1] == row[k].first) {
+                        values[position - 1] += row[k].second;
+                        continue;
+                    }
+                    indices[position] = row[k].first;
+                    values[position] = row[k].second;
+                    ++length;
+                }
+                rowLengths[i] = length;
+            }
+        }
+    );
+    // Close the gaps left by merged duplicates
+    size_t nonZeros = 0;
+    for (size_t i = 0; i < header.rows; ++i) {
+        size_t start = offsets[i];
+        offsets[i] = nonZeros;
+        for (size_t p = start; p < start + rowLengths[i]; ++p, ++nonZeros) {
+            indices[nonZeros] = indices[p];
+            values[nonZeros] = values[p];
+        }
+    }
+    offsets[header.rows] = nonZeros;
+    indices.resize(nonZeros);
+    values.resize(nonZeros);
+    return SparseMatrix<T>(
+        header.rows, header.cols, offsets, indices, values
+    );
+}
+
+/**
+ * Reads a MatrixMarket file (coordinate or array format) into a dense
+ * matrix. Symmetric and skew-symmetric files are expanded. Coordinate
+ * files are assembled like readMatrixMarketSparse(), so duplicate entries
+ * are summed.
+ *
+ * @param path The path of the file to read.
+ * @return A new matrix holding the file's values.
+ * @throws std::runtime_error If the file cannot be read or is malformed.
+ */
+template<typename T>
+Matrix<T> readMatrixMarket(const std::string& path) {
+    MappedFile file(path);
+    MatrixMarketHeader header = readMatrixMarketHeader(file, path);
+    if (header.coordinate)
+        return assembleCoordinateEntries<T>(file, header, path).toDense();
+    std::vector<const char*> bounds = splitAtLines(
+        header.data, file.end(), chunkCountFor(header.data, file.end())
+    );
+    int chunks = static_cast<int>(bounds.size()) - 1;
+    std::vector<long long> firstEntry = countDataLines(bounds, '%');
+    if (firstEntry.back() != header.entries) throw std::runtime_error(
+        path + " does not have the declared number of entries."
+    );
+    Matrix<T> result(header.rows, header.cols);
+    T* out = result.raw();
+    size_t cols = header.cols;
+    bool skew = header.symmetry == MatrixMarketSymmetry::SkewSymmetric;
+    bool mirror = header.symmetry != MatrixMarketSymmetry::General;
+    ThreadPool::instance().parallelFor(chunks, [&](int c) {
+        // Array entries are stored column by column (only the lower
+        // triangle for symmetric files), so locate this chunk's first one
+        long long entry = firstEntry[c];
+        size_t i = 0, j = 0;
+        for (;;) {
+            size_t firstRow = !mirror ? 0 : skew ? j + 1 : j;
+            long long inColumn = static_cast<long long>(header.rows) -
+                                 static_cast<long long>(firstRow);
+            if (j >= header.cols || entry < inColumn) {
+                i = firstRow + static_cast<size_t>(entry);
+                break;
+            }
+            entry -= inColumn;
+            ++j;
+        }
+        forEachDataLine(bounds[c], bounds[c + 1], '%',
+            [&](const char* p, const char* last) {
+                T value = 0;
+                p = parseNumber(p, last, value);
+                if (!p || skipBlanks(p, last) != last)
+                    throw std::runtime_error(
+                        "Malformed entry in " + path + "."
+                    );
+                out[i * cols + j] = value;
+                if (mirror && i != j)
+                    out[j * cols + i] = skew ? -value : value;
+                if (++i == header.rows) {
+                    ++j;
+                    i = !mirror ? 0 : skew ? j + 1 : j;
+                }
+            });
+    });
+    return result;
+}
+
+/**
+ * Reads a MatrixMarket file into a sparse (CSR) matrix. Coordinate files
+ * are parsed in parallel into entry lists and assembled row by row,
+ * summing duplicate entries; array files are read densely and compressed.
+ * Symmetric and skew-symmetric files are expanded.
+ *
+ * @param path The path of the file to read.
+ * @return A new sparse matrix holding the file's entries.
+ * @throws std::runtime_error If the file cannot be read or is malformed.
+ */
+template<typename T>
+SparseMatrix<T> readMatrixMarketSparse(const std::string& path) {
+    MappedFile file(path);
+    MatrixMarketHeader header = readMatrixMarketHeader(file, path);
+    if (!header.coordinate) {
+        Matrix<T> dense = readMatrixMarket<T>(path);
+        std::vector<size_t> offsets(1, 0), indices;
+        std::vector<T> values;
+        for (size_t i = 0; i < dense.getRows(); ++i) {
+            for (size_t j = 0; j < dense.getCols(); ++j) {
+                if (dense(i, j) == T(0)) continue;
+                indices.push_back(j);
+                values.push_back(dense(i, j));
+            }
+            offsets.push_back(values.size());
+        }
+        return SparseMatrix<T>(
+            dense.getRows(), dense.getCols(), offsets, indices, values
+        );
+    }
+    return assembleCoordinateEntries<T>(file, header, path);
+}
+
+#endif // MATRIXREADER_H
@@ -0,0 +1,389 @@
+#ifndef MATRIXWRITER_H
+#define MATRIXWRITER_H
+
+#include "ThreadPool.h"
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <functional>
+#include <type_traits>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <stdexcept>
+
+#include <ostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+template<typename T>
+class Matrix;
+
+/**
+ * Output formats supported by writeMatrix().
+ *
+ * Pretty draws the bracketed, column-aligned layout used by Matrix::print,
+ * CSV and TSV write one row per line separated by commas or tabs.
+ */
+enum class MatrixFormat { Pretty, CSV, TSV };
+
+/**
+ * Options controlling writeMatrix().
+ */
+struct WriterOptions {
+    // Layout of the output
+    MatrixFormat format;
+    // Significant digits of floating-point values; 0 writes max_digits10
+    // digits, which read back to the same value
+    int precision;
+    // Number of spaces before each line (Pretty only)
+    int indent;
+    // Escape sequence written at the start of each line (Pretty only)
+    std::string color;
+
+    WriterOptions() :
+        format(MatrixFormat::Pretty), precision(0), indent(0), color() {}
+};
+
+/**
+ * Destination of formatted output. Called with consecutive chunks of text.
+ */
+typedef std::function<void(const char*, size_t)> MatrixSink;
+
+/* ************************************************************************* */
+/* ************************** Number Formatting **************************** */
+/* ************************************************************************* */
+
+/**
+ * Number of characters sufficient to format any numeric value.
+ */
+const int MAX_NUMBER_CHARS = 64;
+
+/**
+ * Formats an integral value in decimal without allocating.
+ *
+ * @param first Start of a buffer of at least MAX_NUMBER_CHARS characters.
+ * @param value The value to format.
+ * @return Pointer one past the last character written.
+ */
+template<typename T>
+char* toChars(char* first, T value, int, std::true_type) {
+    typedef typename std::make_unsigned<T>::type Unsigned;
+    Unsigned magnitude = static_cast<Unsigned>(value);
+    if (value < 0) {
+        *first++ = '-';
+        magnitude = static_cast<Unsigned>(0) - magnitude;
+    }
+    char digits[MAX_NUMBER_CHARS];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    while (count > 0)
+        *first++ = digits[--count];
+    return first;
+}
+
+/**
+ * Formats a double or long double with the given number of significant
+ * digits.
+ */
+inline char* formatFloating(char* first, double value, int precision) {
+    return first + std::snprintf(
+        first, MAX_NUMBER_CHARS, "%.*g", precision, value
+    );
+}
+
+inline char* formatFloating(char* first, long double value, int precision) {
+    return first + std::snprintf(
+        first, MAX_NUMBER_CHARS, "%.*Lg", precision, value
+    );
+}
+
+/**
+ * Parses a formatted float, double or long double in its own type.
+ */
+inline float parseFloating(const char* text, float) {
+    return std::strtof(text, nullptr);
+}
+
+inline double parseFloating(const char* text, double) {
+    return std::strtod(text, nullptr);
+}
+
+inline long double parseFloating(const char* text, long double) {
+    return std::strtold(text, nullptr);
+}
+
+/**
+ * Formats a floating-point value without allocating. With a precision of
+ * 0, the shortest representation that reads back to the same value is
+ * chosen, starting from digits10 significant digits, which settle most
+ * short values at the first attempt. Only long double values are
+ * formatted and parsed in long double.
+ *
+ * @param first Start of a buffer of at least MAX_NUMBER_CHARS characters.
+ * @param value The value to format.
+ * @param precision Number of significant digits, or 0 for round-trip.
+ * @return Pointer one past the last character written.
+ */
+template<typename T>
+char* toChars(char* first, T value, int precision, std::false_type) {
+    typedef typename std::conditional<
+        std::is_same<T, long double>::value, long double, double
+    >::type Wide;
+    Wide wide = value;
+    if (precision > 0) return formatFloating(first, wide, precision);
+    int digits = std::numeric_limits<T>::digits10;
+    int maxDigits = std::numeric_limits<T>::max_digits10;
+    char* end = formatFloating(first, wide, digits);
+    while (digits < maxDigits && parseFloating(first, value) != value)
+        end = formatFloating(first, wide, ++digits);
+    return end;
+}
+
+/**
+ * Formats a numeric value without allocating, in the spirit of
+ * std::to_chars.
+ *
+ * @param first Start of a buffer of at least MAX_NUMBER_CHARS characters.
+ * @param value The value to format.
+ * @param precision Significant digits of floating-point values, or 0 for
+ *                  a round-trip representation.
+ * @return Pointer one past the last character written.
+ */
+template<typename T>
+char* toChars(char* first, T value, int precision = 0) {
+    static_assert(std::is_arithmetic<T>::value, "T must be numeric.");
+    return toChars(
+        first, value, precision,
+        std::integral_constant<bool, std::is_integral<T>::value>()
+    );
+}
+
+/* ************************************************************************* */
+/* ************************** Matrix Formatting **************************** */
+/* ************************************************************************* */
+
+/**
+ * Computes the formatted width of each column, scanning blocks of rows in
+ * parallel. The formatted text is discarded; only the widths are kept.
+ *
+ * @param M The matrix to measure.
+ * @param precision Significant digits of floating-point values.
+ * @return A vector containing the maximum width for each column.
+ */
+template<typename T>
+std::vector<int> formattedColumnWidths(const Matrix<T>& M, int precision) {
+    size_t rows = M.getRows(), cols = M.getCols();
+    size_t blockSize = 256;
+    size_t blockCount = (rows + blockSize - 1) / blockSize;
+    std::vector<std::vector<int>> blockWidths(blockCount);
+    const T* values = M.raw();
+    ThreadPool::instance().parallelFor(blockCount, [&](size_t b) {
+        std::vector<int>& widths = blockWidths[b];
+        widths.assign(cols, 0);
+        char buffer[MAX_NUMBER_CHARS];
+        size_t end = std::min(rows, (b + 1) * blockSize);
+        for (size_t i = b * blockSize; i < end; ++i) {
+            const T* row = values + i * cols;
+            for (size_t j = 0; j < cols; ++j) {
+                int width = static_cast<int>(
+                    toChars(buffer, row[j], precision) - buffer
+                );
+                widths[j] = std::max(widths[j], width);
+            }
+        }
+    });
+    std::vector<int> columnWidths(cols, 0);
+    for (const auto& widths : blockWidths)
+        for (size_t j = 0; j < cols; ++j)
+            columnWidths[j] = std::max(columnWidths[j], widths[j]);
+    return columnWidths;
+}
+
+/**
+ * Appends the formatted rows [rowStart, rowEnd) of a matrix to a buffer.
+ *
+ * @param M The matrix to format.
+ * @param rowStart The first row to format.
+ * @param rowEnd One past the last row to format.
+ * @param options The output options.
+ * @param columnWidths Widths of the columns (Pretty only).
+ * @param out The buffer the text is appended to.
+ */
+template<typename T>
+void formatRows(
+    const Matrix<T>& M, size_t rowStart, size_t rowEnd,
+    const WriterOptions& options, const std::vector<int>& columnWidths,
+    std::string& out
+) {
+    const std::string resetColorCode = "\033[0m";
+    std::string padding(options.indent, ' ');
+    char buffer[MAX_NUMBER_CHARS];
+    char separator = options.format == MatrixFormat::TSV ? '\t' : ',';
+    bool pretty = options.format == MatrixFormat::Pretty;
+    size_t cols = M.getCols();
+    for (size_t i = rowStart; i < rowEnd; ++i) {
+        const T* row = M.raw() + i * cols;
+        if (pretty) out.append(options.color).append(padding).append("|");
+        for (size_t j = 0; j < cols; ++j) {
+            char* end = toChars(buffer, row[j], options.precision);
+            int length = static_cast<int>(end - buffer);
+            if (pretty) {
+                out.push_back(' ');
+                out.append(std::max(0, columnWidths[j] - length), ' ');
+            } else if (j > 0) {
+                out.push_back(separator);
+            }
+            out.append(buffer, length);
+        }
+        if (pretty)
+            out.append(" |\n").append(resetColorCode);
+        else
+            out.push_back('\n');
+    }
+}
+
+/* ************************************************************************* */
+/* **************************** Matrix Writers ***************************** */
+/* ************************************************************************* */
+
+/**
+ * Formats a matrix and streams the text to a sink. Blocks of rows are
+ * formatted in parallel and handed to the sink in order, a bounded batch
+ * at a time, so memory use does not grow with the size of the matrix.
+ * Pretty output first measures the column widths in a separate parallel
+ * pass and formats each element again when writing it.
+ *
+ * @param sink The destination of the formatted text.
+ * @param M The matrix to write.
+ * @param options The output options.
+ */
+template<typename T>
+void writeMatrix(
+    const MatrixSink& sink, const Matrix<T>& M,
+    const WriterOptions& options = WriterOptions()
+) {
+    size_t rows = M.getRows(), cols = M.getCols();
+    bool pretty = options.format == MatrixFormat::Pretty;
+    std::vector<int> columnWidths;
+    std::string border;
+    if (pretty) {
+        columnWidths = formattedColumnWidths(M, options.precision);
+        size_t totalWidth = cols;
+        for (int width : columnWidths)
+            totalWidth += width;
+        border = std::string(totalWidth + 1, ' ');
+        std::string top = options.color + std::string(options.indent, ' ')
+            + "┌" + border + "┐\n\033[0m";
+        sink(top.data(), top.size());
+    }
+    // Format about 1 MiB of text per block, a few blocks per worker per batch
+    size_t rowsPerBlock =
+        std::max<size_t>(1, (1 << 20) / std::max<size_t>(1, cols * 12));
+    size_t blocksPerBatch = 4 * ThreadPool::instance().size();
+    std::vector<std::string> blocks(blocksPerBatch);
+    for (size_t batchStart = 0; batchStart < rows;
+         batchStart += rowsPerBlock * blocksPerBatch) {
+        size_t blockCount = std::min(
+            blocksPerBatch,
+            (rows - batchStart + rowsPerBlock - 1) / rowsPerBlock
+        );
+        ThreadPool::instance().parallelFor(blockCount, [&](size_t b) {
+            size_t rowStart = batchStart + b * rowsPerBlock;
+            size_t rowEnd = std::min(rows, rowStart + rowsPerBlock);
+            blocks[b].clear();
+            formatRows(M, rowStart, rowEnd, options, columnWidths, blocks[b]);
+        });
+        for (size_t b = 0; b < blockCount; ++b)
+            sink(blocks[b].data(), blocks[b].size());
+    }
+    if (pretty) {
+        std::string bottom = options.color + std::string(options.indent, ' ')
+            + "└" + border + "┘\n\033[0m";
+        sink(bottom.data(), bottom.size());
+    }
+}
+
+/**
+ * Formats a matrix and writes it to an output stream.
+ *
+ * @param stream The stream to write to.
+ * @param M The matrix to write.
+ * @param options The output options.
+ */
+template<typename T>
+void writeMatrix(
+    std::ostream& stream, const Matrix<T>& M,
+    const WriterOptions& options = WriterOptions()
+) {
+    writeMatrix(MatrixSink([&stream](const char* text, size_t length) {
+        stream.write(text, static_cast<std::streamsize>(length));
+    }), M, options);
+}
+
+/**
+ * Formats a matrix and writes it to a file descriptor.
+ *
+ * @param fd The file descriptor to write to.
+ * @param M The matrix to write.
+ * @param options The output options.
+ * @throws std::runtime_error If writing fails.
+ */
+template<typename T>
+void writeMatrix(
+    int fd, const Matrix<T>& M,
+    const WriterOptions& options = WriterOptions()
+) {
+    writeMatrix(MatrixSink([fd](const char* text, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::write(fd, text, length);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(
+                    std::string("Failed to write matrix: ")
+                    + std::strerror(errno)
+                );
+            }
+            text += written;
+            length -= static_cast<size_t>(written);
+        }
+    }), M, options);
+}
+
+/**
+ * Formats a matrix and writes it to a file, replacing its contents.
+ *
+ * @param path The path of the file to write.
+ * @param M The matrix to write.
+ * @param options The output options.
+ * @throws std::runtime_error If the file cannot be opened or written.
+ */
+template<typename T>
+void writeMatrix(
+    const std::string& path, const Matrix<T>& M,
+    const WriterOptions& options = WriterOptions()
+) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error(
+        "Failed to open " + path + ": " + std::strerror(errno)
+    );
+    try {
+        writeMatrix(fd, M, options);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0) throw std::runtime_error(
+        "Failed to close " + path + ": " + std::strerror(errno)
+    );
+}
+
+#endif // MATRIXWRITER_H
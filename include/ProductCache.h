@@ -0,0 +1,255 @@
+#ifndef PRODUCTCACHE_H
+#define PRODUCTCACHE_H
+
+#include "MatrixLib.h"
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include <mutex>
+#include <cstdint>
+
+/**
+ * Computes op(A) * op(B). ProductCache::multiply() hides the multiply()
+ * found by argument-dependent lookup, so it calls through this function.
+ */
+template<typename T>
+Matrix<T> computeProduct(
+    const Matrix<T>& A, Op opA, const Matrix<T>& B, Op opB
+) {
+    return multiply(A, opA, B, opB);
+}
+
+/**
+ * Product Cache
+ *
+ * An opt-in, size-bounded LRU cache of multiplication results, keyed by the
+ * content hashes of the operands (see Matrix<T>::contentHash()), their
+ * dimensions and the operation. Repeated products of unchanged operands are
+ * returned without recomputation; since operand hashes are cached on the
+ * matrices and returned results share the cached storage, a hit costs
+ * only a lookup.
+ *
+ * Keys compare 64-bit hashes, not elements, so distinct operands whose
+ * hashes collide would share an entry; for non-adversarial inputs the
+ * probability is about 2^-64 per pair.
+ *
+ * The cache is safe to use from several threads. Concurrent misses on the
+ * same key may each compute the product.
+ *
+ * Usage example:
+ * ProductCache<double> cache(256 << 20); // at most 256 MiB of results
+ * Matrix<double> C = cache.multiply(W, x);
+ * std::cout << cache.hits() << " hits\n";
+ */
+template<typename T>
+class ProductCache {
+private:
+    /**
+     * Identifies a product by its operation and operands.
+     */
+    struct Key {
+        Op opA, opB;
+        size_t rowsA, colsA, rowsB, colsB;
+        uint64_t hashA, hashB;
+
+        bool operator==(const Key& other) const {
+            return opA == other.opA && opB == other.opB &&
+                   rowsA == other.rowsA && colsA == other.colsA &&
+                   rowsB == other.rowsB && colsB == other.colsB &&
+                   hashA == other.hashA && hashB == other.hashB;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            uint64_t mixed = key.hashA * hashing::PRIME1 ^ key.hashB;
+            mixed ^= static_cast<uint64_t>(key.opA) << 1 ^
+                     static_cast<uint64_t>(key.opB);
+            return static_cast<size_t>(mixed);
+        }
+    };
+
+    struct Entry {
+        Key key;
+        Matrix<T> value;
+        size_t bytes;
+    };
+
+    typedef typename std::list<Entry>::iterator EntryIterator;
+
+    mutable std::mutex mutex;
+    size_t capacityBytes;
+    size_t usedBytes;
+    size_t hitCount, missCount;
+    // Most recently used entries first
+    std::list<Entry> entries;
+    std::unordered_map<Key, EntryIterator, KeyHash> index;
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs an empty cache.
+     *
+     * @param capacityBytes Maximum total size of the cached results, in
+     *                      bytes of element storage.
+     */
+    explicit ProductCache(size_t capacityBytes) :
+        capacityBytes(capacityBytes), usedBytes(0),
+        hitCount(0), missCount(0) {}
+
+    /* ********************************************************************* */
+    /* ***************************** Accessors ***************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Returns the number of products served from the cache.
+     *
+     * @return Count of cache hits.
+     */
+    size_t hits() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hitCount;
+    }
+
+    /**
+     * Returns the number of products that had to be computed.
+     *
+     * @return Count of cache misses.
+     */
+    size_t misses() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return missCount;
+    }
+
+    /**
+     * Returns the number of cached results.
+     *
+     * @return Count of entries.
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    /**
+     * Returns the total size of the cached results.
+     *
+     * @return Bytes of element storage held by the cache.
+     */
+    size_t memoryUsage() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return usedBytes;
+    }
+
+    /**
+     * Returns the maximum total size of the cached results.
+     *
+     * @return The memory cap in bytes.
+     */
+    size_t capacity() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return capacityBytes;
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Operations **************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Returns op(A) * op(B), from the cache if an identical product was
+     * computed before, otherwise by computing and caching it. Results
+     * larger than the capacity are returned without being cached.
+     *
+     * @param A The left-hand side matrix.
+     * @param opA The operation applied to A.
+     * @param B The right-hand side matrix.
+     * @param opB The operation applied to B.
+     * @return A new matrix representing op(A) * op(B).
+     * @throws std::invalid_argument If the dimensions are incompatible.
+     */
+    Matrix<T> multiply(
+        const Matrix<T>& A, Op opA, const Matrix<T>& B, Op opB
+    ) {
+        Key key = {
+            opA, opB, A.getRows(), A.getCols(), B.getRows(), B.getCols(),
+            A.contentHash(), B.contentHash()
+        };
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = index.find(key);
+            if (found != index.end()) {
+                ++hitCount;
+                entries.splice(entries.begin(), entries, found->second);
+                return found->second->value;
+            }
+            ++missCount;
+        }
+        Matrix<T> product = computeProduct(A, opA, B, opB);
+        size_t bytes = product.getRows() * product.getCols() * sizeof(T);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bytes > capacityBytes || index.find(key) != index.end())
+            return product;
+        entries.push_front(Entry{key, product, bytes});
+        index[key] = entries.begin();
+        usedBytes += bytes;
+        evict();
+        return product;
+    }
+
+    /**
+     * Returns A * B, from the cache if possible.
+     *
+     * @param A The left-hand side matrix.
+     * @param B The right-hand side matrix.
+     * @return A new matrix representing A * B.
+     */
+    Matrix<T> multiply(const Matrix<T>& A, const Matrix<T>& B) {
+        return multiply(A, Op::None, B, Op::None);
+    }
+
+    /**
+     * Changes the memory cap, evicting least recently used results until
+     * the cached results fit.
+     *
+     * @param bytes The new maximum total size of the cached results.
+     */
+    void setCapacity(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        capacityBytes = bytes;
+        evict();
+    }
+
+    /**
+     * Removes all cached results. The hit and miss counters are kept.
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+        usedBytes = 0;
+    }
+
+private:
+    /* ********************************************************************* */
+    /* ************************** Helper Functions ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Evicts least recently used results until the cache fits its
+     * capacity. The mutex must be held.
+     */
+    void evict() {
+        while (usedBytes > capacityBytes && !entries.empty()) {
+            usedBytes -= entries.back().bytes;
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+    }
+};
+
+#endif // PRODUCTCACHE_H
@@ -0,0 +1,178 @@
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+
+#include "MatrixLib.h"
+#include "ThreadPool.h"
+
+#include <vector>
+#include <utility>
+
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Sparse Matrix
+ *
+ * A matrix in compressed sparse row (CSR) form: the column indices and
+ * values of row i are stored at positions [rowOffsets[i], rowOffsets[i + 1])
+ * of columnIndices and values, sorted by column.
+ *
+ * Usage example:
+ * SparseMatrix<double> S = readMatrixMarketSparse<double>("A.mtx");
+ * Matrix<double> C = S * B;
+ */
+template<typename T>
+class SparseMatrix {
+private:
+    size_t rows, cols;
+    std::vector<size_t> rowOffsets;
+    std::vector<size_t> columnIndices;
+    std::vector<T> values;
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs a sparse matrix from its CSR arrays.
+     *
+     * @param rows Number of rows in the matrix.
+     * @param cols Number of columns in the matrix.
+     * @param rowOffsets Start of each row in the entry arrays, followed by
+     *                   the total number of entries (rows + 1 values).
+     * @param columnIndices Column index of each entry.
+     * @param values Value of each entry.
+     */
+    SparseMatrix(
+        size_t rows, size_t cols, std::vector<size_t> rowOffsets,
+        std::vector<size_t> columnIndices, std::vector<T> values
+    ) :
+        rows(rows), cols(cols),
+        rowOffsets(std::move(rowOffsets)),
+        columnIndices(std::move(columnIndices)),
+        values(std::move(values)) {
+        if (this->rowOffsets.size() != rows + 1 ||
+            this->columnIndices.size() != this->values.size() ||
+            this->rowOffsets.back() != this->values.size()) {
+            throw std::invalid_argument("Inconsistent CSR arrays.");
+        }
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Accessors ***************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Returns the number of rows in the matrix.
+     *
+     * @return Integer count of rows.
+     */
+    size_t getRows() const {
+        return rows;
+    }
+
+    /**
+     * Returns the number of columns in the matrix.
+     *
+     * @return Integer count of columns.
+     */
+    size_t getCols() const {
+        return cols;
+    }
+
+    /**
+     * Returns the number of stored entries.
+     *
+     * @return Integer count of stored entries.
+     */
+    size_t getNonZeros() const {
+        return values.size();
+    }
+
+    /**
+     * Returns the start of each row in the entry arrays.
+     *
+     * @return Const reference to the rows + 1 row offsets.
+     */
+    const std::vector<size_t>& getRowOffsets() const {
+        return rowOffsets;
+    }
+
+    /**
+     * Returns the column index of each stored entry.
+     *
+     * @return Const reference to the column indices.
+     */
+    const std::vector<size_t>& getColumnIndices() const {
+        return columnIndices;
+    }
+
+    /**
+     * Returns the value of each stored entry.
+     *
+     * @return Const reference to the values.
+     */
+    const std::vector<T>& getValues() const {
+        return values;
+    }
+
+    /* ********************************************************************* */
+    /* ************************* Matrix Operations ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Converts the matrix to dense storage.
+     *
+     * @return A new dense matrix with the same elements.
+     */
+    Matrix<T> toDense() const {
+        Matrix<T> result(rows, cols);
+        T* out = result.raw();
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t p = rowOffsets[i]; p < rowOffsets[i + 1]; ++p)
+                out[i * cols + columnIndices[p]] = values[p];
+        return result;
+    }
+
+    /**
+     * Multiplies this sparse matrix by a dense matrix. Blocks of rows are
+     * computed in parallel, and each row is summed in
+     * Accumulator<T>::type before being stored.
+     *
+     * @param other The dense matrix to multiply by.
+     * @return A new dense matrix representing the product.
+     */
+    Matrix<T> operator*(const Matrix<T>& other) const {
+        if (cols != other.getRows()) throw std::invalid_argument(
+            "Incompatible dimensions for multiplication."
+        );
+        typedef typename Accumulator<T>::type Acc;
+        size_t n = other.getCols();
+        Matrix<T> result(rows, n);
+        const T* in = other.raw();
+        T* out = result.raw();
+        size_t blockSize = 128;
+        ThreadPool::instance().parallelFor(
+            (rows + blockSize - 1) / blockSize, [&](size_t b) {
+                size_t end = std::min(rows, (b + 1) * blockSize);
+                std::vector<Acc> sums(n);
+                for (size_t i = b * blockSize; i < end; ++i) {
+                    std::fill(sums.begin(), sums.end(), Acc(0));
+                    for (size_t p = rowOffsets[i]; p < rowOffsets[i + 1]; ++p) {
+                        const T* source = in + columnIndices[p] * n;
+                        Acc value = values[p];
+                        for (size_t j = 0; j < n; ++j)
+                            sums[j] += value * source[j];
+                    }
+                    T* row = out + i * n;
+                    for (size_t j = 0; j < n; ++j)
+                        row[j] = static_cast<T>(sums[j]);
+                }
+            }
+        );
+        return result;
+    }
+};
+
+#endif // SPARSEMATRIX_H
@@ -0,0 +1,698 @@
+#ifndef STRUCTUREDMATRIX_H
+#define STRUCTUREDMATRIX_H
+
+#include "MatrixLib.h"
+#include "ThreadPool.h"
+
+#include <vector>
+#include <utility>
+
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Structured Matrices
+ *
+ * Diagonal, banded and triangular matrices that store only the elements
+ * inside their structure, with multiplication kernels against dense
+ * Matrix<T> operands that skip the structural zeros. All kernels split the
+ * dense result into blocks of rows computed in parallel on the shared
+ * ThreadPool, and compute in Accumulator<T>::type like the dense kernels.
+ *
+ * Usage example:
+ * auto I = DiagonalMatrix<int>::identity(3);
+ * TriangularMatrix<double> L(A.cholesky(), Triangle::Lower);
+ * Matrix<double> X = L.solve(B);
+ */
+
+/**
+ * Runs body(rowStart, rowEnd) over blocks of [0, rows) in parallel.
+ */
+template<typename Body>
+void forEachRowBlock(size_t rows, Body body) {
+    size_t blockSize = 64;
+    ThreadPool::instance().parallelFor(
+        (rows + blockSize - 1) / blockSize, [&](size_t b) {
+            body(b * blockSize, std::min(rows, (b + 1) * blockSize));
+        }
+    );
+}
+
+/* ************************************************************************* */
+/* *************************** Diagonal Matrix ***************************** */
+/* ************************************************************************* */
+
+/**
+ * A square matrix whose only nonzero elements are on its diagonal.
+ */
+template<typename T>
+class DiagonalMatrix {
+private:
+    std::vector<T> diagonal;
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs a diagonal matrix from its diagonal elements.
+     *
+     * @param diagonal The elements of the diagonal, top-left first.
+     */
+    explicit DiagonalMatrix(std::vector<T> diagonal) :
+        diagonal(std::move(diagonal)) {}
+
+    /**
+     * Constructs the identity matrix of a given size.
+     *
+     * @param size Number of rows and columns.
+     * @return The identity matrix.
+     */
+    static DiagonalMatrix<T> identity(size_t size) {
+        return DiagonalMatrix<T>(std::vector<T>(size, 1));
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Accessors ***************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Returns the number of rows (and columns) in the matrix.
+     *
+     * @return Integer count of rows.
+     */
+    size_t getRows() const {
+        return diagonal.size();
+    }
+
+    /**
+     * Returns the number of columns (and rows) in the matrix.
+     *
+     * @return Integer count of columns.
+     */
+    size_t getCols() const {
+        return getRows();
+    }
+
+    /**
+     * Accesses an element of the diagonal. Provides modifiable access.
+     *
+     * @param row The zero-based index of the row.
+     * @param col The zero-based index of the column.
+     * @return Reference to the matrix element.
+     * @throws std::out_of_range If the element is not on the diagonal.
+     */
+    T& operator()(size_t row, size_t col) {
+        if (row != col) throw std::out_of_range(
+            "Element is outside the diagonal."
+        );
+        return diagonal[row];
+    }
+
+    /**
+     * Returns the element at the specified row and column.
+     *
+     * @param row The zero-based index of the row.
+     * @param col The zero-based index of the column.
+     * @return The matrix element (zero off the diagonal).
+     */
+    T operator()(size_t row, size_t col) const {
+        return row == col ? diagonal[row] : T(0);
+    }
+
+    /* ********************************************************************* */
+    /* ************************* Matrix Operations ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Converts the matrix to dense storage.
+     *
+     * @return A new dense matrix with the same elements.
+     */
+    Matrix<T> toDense() const {
+        Matrix<T> result(getRows(), getCols());
+        for (size_t i = 0; i < getRows(); ++i)
+            result(i, i) = diagonal[i];
+        return result;
+    }
+
+    /**
+     * Multiplies two diagonal matrices.
+     *
+     * @param other The diagonal matrix to multiply by.
+     * @return A new diagonal matrix representing the product.
+     */
+    DiagonalMatrix<T> operator*(const DiagonalMatrix<T>& other) const {
+        if (getCols() != other.getRows()) throw std::invalid_argument(
+            "Incompatible dimensions for multiplication."
+        );
+        typedef typename Accumulator<T>::type Acc;
+        std::vector<T> product(diagonal.size());
+        for (size_t i = 0; i < product.size(); ++i)
+            product[i] = static_cast<T>(
+                static_cast<Acc>(diagonal[i]) * other.diagonal[i]
+            );
+        return DiagonalMatrix<T>(product);
+    }
+
+    /**
+     * Multiplies this diagonal matrix by a dense matrix, scaling each of
+     * its rows in O(rows * cols).
+     *
+     * @param other The dense matrix to multiply by.
+     * @return A new dense matrix representing the product.
+     */
+    Matrix<T> operator*(const Matrix<T>& other) const {
+        if (getCols() != other.getRows()) throw std::invalid_argument(
+            "Incompatible dimensions for multiplication."
+        );
+        typedef typename Accumulator<T>::type Acc;
+        size_t n = other.getCols();
+        Matrix<T> result(getRows(), n);
+        const T* in = other.raw();
+        T* out = result.raw();
+        forEachRowBlock(getRows(), [&](size_t rowStart, size_t rowEnd) {
+            for (size_t i = rowStart; i < rowEnd; ++i) {
+                Acc scale = diagonal[i];
+                for (size_t j = 0; j < n; ++j)
+                    out[i * n + j] = static_cast<T>(scale * in[i * n + j]);
+            }
+        });
+        return result;
+    }
+
+    /**
+     * Multiplies a dense matrix by a diagonal matrix, scaling each of its
+     * columns in O(rows * cols).
+     *
+     * @param lhs The dense matrix.
+     * @param rhs The diagonal matrix to multiply by.
+     * @return A new dense matrix representing the product.
+     */
+    friend Matrix<T> operator*(
+        const Matrix<T>& lhs, const DiagonalMatrix<T>& rhs
+    ) {
+        if (lhs.getCols() != rhs.getRows()) throw std::invalid_argument(
+            "Incompatible dimensions for multiplication."
+        );
+        typedef typename Accumulator<T>::type Acc;
+        size_t n = lhs.getCols();
+        Matrix<T> result(lhs.getRows(), n);
+        const T* in = lhs.raw();
+        T* out = result.raw();
+        forEachRowBlock(lhs.getRows(), [&](size_t rowStart, size_t rowEnd) {
+            for (size_t i = rowStart; i < rowEnd; ++i)
+                for (size_t j = 0; j < n; ++j)
+                    out[i * n + j] = static_cast<T>(
+                        static_cast<Acc>(in[i * n + j]) * rhs.diagonal[j]
+                    );
+        });
+        return result;
+    }
+};
+
+/* ************************************************************************* */
+/* **************************** Banded Matrix ****************************** */
+/* ************************************************************************* */
+
+/**
+ * A matrix whose nonzero elements lie within kl subdiagonals and ku
+ * superdiagonals, i.e. element (i, j) is zero unless -kl <= j - i <= ku.
+ * Each row stores its kl + ku + 1 band elements contiguously.
+ */
+template<typename T>
+class BandedMatrix {
+private:
+    size_t rows, cols, kl, ku;
+    std::vector<T> band;
+
+    /**
+     * Returns the offset of element (row, col) in the band storage.
+     */
+    size_t offset(size_t row, size_t col) const {
+        return row * (kl + ku + 1) + (col + kl - row);
+    }
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs a zero-initialized banded matrix.
+     *
+     * @param rows Number of rows in the matrix.
+     * @param cols Number of columns in the matrix.
+     * @param kl Number of subdiagonals.
+     * @param ku Number of superdiagonals.
+     */
+    BandedMatrix(size_t rows, size_t cols, size_t kl, size_t ku) :
+        rows(rows), cols(cols), kl(kl), ku(ku),
+        band(rows * (kl + ku + 1), 0) {}
+
+    /**
+     * Constructs a banded matrix from the band of a dense matrix.
+     * Elements outside the band are ignored.
+     *
+     * @param dense The dense matrix to copy the band from.
+     * @param kl Number of subdiagonals.
+     * @param ku Number of superdiagonals.
+     */
+    BandedMatrix(const Matrix<T>& dense, size_t kl, size_t ku) :
+        BandedMatrix(dense.getRows(), dense.getCols(), kl, ku) {
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t j = firstCol(i); j < endCol(i); ++j)
+                band[offset(i, j)] = dense(i, j);
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Accessors ***************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Returns the number of rows in the matrix.
+     *
+     * @return Integer count of rows.
+     */
+    size_t getRows() const {
+        return rows;
+    }
+
+    /**
+     * Returns the number of columns in the matrix.
+     *
+     * @return Integer count of columns.
+     */
+    size_t getCols() const {
+        return cols;
+    }
+
+    /**
+     * Returns the first column inside the band of a row.
+     *
+     * @param row The zero-based index of the row.
+     * @return Index of the first column of the band.
+     */
+    size_t firstCol(size_t row) const {
+        return row > kl ? row - kl : 0;
+    }
+
+    /**
+     * Returns one past the last column inside the band of a row.
+     *
+     * @param row The zero-based index of the row.
+     * @return One past the index of the last column of the band.
+     */
+    size_t endCol(size_t row) const {
+        return std::min(cols, row + ku + 1);
+    }
+
+    /**
+     * Accesses an element inside the band. Provides modifiable access.
+     *
+     * @param row The zero-based index of the row.
+     * @param col The zero-based index of the column.
+     * @return Reference to the matrix element.
+     * @throws std::out_of_range If the element is outside the band.
+     */
+    T& operator()(size_t row, size_t col) {
+        if (col < firstCol(row) || col >= endCol(row))
+            throw std::out_of_range("Element is outside the band.");
+        return band[offset(row, col)];
+    }
+
+    /**
+     * Returns the element at the specified row and column.
+     *
+     * @param row The zero-based index of the row.
+     * @param col The zero-based index of the column.
+     * @return The matrix element (zero outside the band).
+     */
+    T operator()(size_t row, size_t col) const {
+        if (col < firstCol(row) || col >= endCol(row)) return T(0);
+        return band[offset(row, col)];
+    }
+
+    /* ********************************************************************* */
+    /* ************************* Matrix Operations ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Converts the matrix to dense storage.
+     *
+     * @return A new dense matrix with the same elements.
+     */
+    Matrix<T> toDense() const {
+        Matrix<T> result(rows, cols);
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t j = firstCol(i); j < endCol(i); ++j)
+                result(i, j) = band[offset(i, j)];
+        return result;
+    }
+
+    /**
+     * Multiplies this banded matrix by a dense matrix in
+     * O(rows * (kl + ku + 1) * other.cols).
+     *
+     * @param other The dense matrix to multiply by.
+     * @return A new dense matrix representing the product.
+     */
+    Matrix<T> operator*(const Matrix<T>& other) const {
+        if (cols != other.getRows()) throw std::invalid_argument(
+            "Incompatible dimensions for multiplication."
+        );
+        typedef typename Accumulator<T>::type Acc;
+        size_t n = other.getCols();
+        Matrix<T> result(rows, n);
+        const T* in = other.raw();
+        T* out = result.raw();
+        forEachRowBlock(rows, [&](size_t rowStart, size_t rowEnd) {
+            std::vector<Acc> sums(n);
+            for (size_t i = rowStart; i < rowEnd; ++i) {
+                std::fill(sums.begin(), sums.end(), Acc(0));
+                // C(i, :) += B(i, k) * A(k, :) over the band of row i
+                for (size_t k = firstCol(i); k < endCol(i); ++k) {
+                    Acc scale = band[offset(i, k)];
+                    for (size_t j = 0; j < n; ++j)
+                        sums[j] += scale * in[k * n + j];
+                }
+                for (size_t j = 0; j < n; ++j)
+                    out[i * n + j] = static_cast<T>(sums[j]);
+            }
+        });
+        return result;
+    }
+
+    /**
+     * Multiplies a dense matrix by a banded matrix in
+     * O(lhs.rows * (kl + ku + 1) * cols).
+     *
+     * @param lhs The dense matrix.
+     * @param rhs The banded matrix to multiply by.
+     * @return A new dense matrix representing the product.
+     */
+    friend Matrix<T> operator*(
+        const Matrix<T>& lhs, const BandedMatrix<T>& rhs
+    ) {
+        if (lhs.getCols() != rhs.rows) throw std::invalid_argument(
+            "Incompatible dimensions for multiplication."
+        );
+        typedef typename Accumulator<T>::type Acc;
+        size_t inner = lhs.getCols(), n = rhs.cols;
+        Matrix<T> result(lhs.getRows(), n);
+        const T* in = lhs.raw();
+        T* out = result.raw();
+        forEachRowBlock(lhs.getRows(), [&](size_t rowStart, size_t rowEnd) {
+            std::vector<Acc> sums(n);
+            for (size_t i = rowStart; i < rowEnd; ++i) {
+                std::fill(sums.begin(), sums.end(), Acc(0));
+                // C(i, :) += A(i, k) * B(k, :) over the band of each row k
+                for (size_t k = 0; k < inner; ++k) {
+                    Acc scale = in[i * inner + k];
+                    for (size_t j = rhs.firstCol(k); j < rhs.endCol(k); ++j)
+                        sums[j] += scale * rhs.band[rhs.offset(k, j)];
+                }
+                for (size_t j = 0; j < n; ++j)
+                    out[i * n + j] = static_cast<T>(sums[j]);
+            }
+        });
+        return result;
+    }
+};
+
+/* ************************************************************************* */
+/* ************************** Triangular Matrix **************************** */
+/* ************************************************************************* */
+
+/**
+ * A square lower- or upper-triangular matrix. Rows are packed without their
+ * structural zeros: lower row i stores columns [0, i], upper row i stores
+ * columns [i, n).
+ */
+template<typename T>
+class TriangularMatrix {
+private:
+    size_t size;
+    Triangle triangle;
+    std::vector<T> packed;
+
+    /**
+     * Returns the offset of element (row, col) in the packed storage.
+     */
+    size_t offset(size_t row, size_t col) const {
+        if (triangle == Triangle::Lower)
+            return row * (row + 1) / 2 + col;
+        return row * size - row * (row - 1) / 2 + (col - row);
+    }
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs a zero-initialized triangular matrix.
+     *
+     * @param size Number of rows and columns.
+     * @param triangle Which triangle holds the nonzero elements.
+     */
+    TriangularMatrix(size_t size, Triangle triangle) :
+        size(size), triangle(triangle),
+        packed(size * (size + 1) / 2, 0) {}
+
+    /**
+     * Constructs a triangular matrix from a triangle of a dense matrix.
+     * Elements outside the triangle are ignored.
+     *
+     * @param dense The square dense matrix to copy the triangle from.
+     * @param triangle Which triangle to copy.
+     */
+    TriangularMatrix(const Matrix<T>& dense, Triangle triangle) :
+        TriangularMatrix(dense.getRows(), triangle) {
+        if (dense.getRows() != dense.getCols()) throw std::invalid_argument(
+            "Triangular matrices must be square."
+        );
+        for (size_t i = 0; i < size; ++i)
+            for (size_t j = firstCol(i); j < endCol(i); ++j)
+                packed[offset(i, j)] = dense(i, j);
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Accessors ***************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Returns the number of rows (and columns) in the matrix.
+     *
+     * @return Integer count of rows.
+     */
+    size_t getRows() const {
+        return size;
+    }
+
+    /**
+     * Returns the number of columns (and rows) in the matrix.
+     *
+     * @return Integer count of columns.
+     */
+    size_t getCols() const {
+        return size;
+    }
+
+    /**
+     * Returns which triangle holds the nonzero elements.
+     *
+     * @return The stored triangle.
+     */
+    Triangle getTriangle() const {
+        return triangle;
+    }
+
+    /**
+     * Returns the first column inside the triangle of a row.
+     *
+     * @param row The zero-based index of the row.
+     * @return Index of the first stored column.
+     */
+    size_t firstCol(size_t row) const {
+        return triangle == Triangle::Lower ? 0 : row;
+    }
+
+    /**
+     * Returns one past the last column inside the triangle of a row.
+     *
+     * @param row The zero-based index of the row.
+     * @return One past the index of the last stored column.
+     */
+    size_t endCol(size_t row) const {
+        return triangle == Triangle::Lower ? row + 1 : size;
+    }
+
+    /**
+     * Accesses an element inside the triangle. Provides modifiable access.
+     *
+     * @param row The zero-based index of the row.
+     * @param col The zero-based index of the column.
+     * @return Reference to the matrix element.
+     * @throws std::out_of_range If the element is outside the triangle.
+     */
+    T& operator()(size_t row, size_t col) {
+        if (col < firstCol(row) || col >= endCol(row))
+            throw std::out_of_range("Element is outside the triangle.");
+        return packed[offset(row, col)];
+    }
+
+    /**
+     * Returns the element at the specified row and column.
+     *
+     * @param row The zero-based index of the row.
+     * @param col The zero-based index of the column.
+     * @return The matrix element (zero outside the triangle).
+     */
+    T operator()(size_t row, size_t col) const {
+        if (col < firstCol(row) || col >= endCol(row)) return T(0);
+        return packed[offset(row, col)];
+    }
+
+    /* ********************************************************************* */
+    /* ************************* Matrix Operations ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Converts the matrix to dense storage.
+     *
+     * @return A new dense matrix with the same elements.
+     */
+    Matrix<T> toDense() const {
+        Matrix<T> result(size, size);
+        for (size_t i = 0; i < size; ++i)
+            for (size_t j = firstCol(i); j < endCol(i); ++j)
+                result(i, j) = packed[offset(i, j)];
+        return result;
+    }
+
+    /**
+     * Multiplies this triangular matrix by a dense matrix, skipping the
+     * zero triangle (about half the work of a dense product).
+     *
+     * @param other The dense matrix to multiply by.
+     * @return A new dense matrix representing the product.
+     */
+    Matrix<T> operator*(const Matrix<T>& other) const {
+        if (size != other.getRows()) throw std::invalid_argument(
+            "Incompatible dimensions for multiplication."
+        );
+        typedef typename Accumulator<T>::type Acc;
+        size_t n = other.getCols();
+        Matrix<T> result(size, n);
+        const T* in = other.raw();
+        T* out = result.raw();
+        forEachRowBlock(size, [&](size_t rowStart, size_t rowEnd) {
+            std::vector<Acc> sums(n);
+            for (size_t i = rowStart; i < rowEnd; ++i) {
+                std::fill(sums.begin(), sums.end(), Acc(0));
+                const T* row = &packed[offset(i, firstCol(i))];
+                for (size_t k = firstCol(i); k < endCol(i); ++k) {
+                    Acc scale = row[k - firstCol(i)];
+                    for (size_t j = 0; j < n; ++j)
+                        sums[j] += scale * in[k * n + j];
+                }
+                for (size_t j = 0; j < n; ++j)
+                    out[i * n + j] = static_cast<T>(sums[j]);
+            }
+        });
+        return result;
+    }
+
+    /**
+     * Multiplies a dense matrix by a triangular matrix, skipping the zero
+     * triangle.
+     *
+     * @param lhs The dense matrix.
+     * @param rhs The triangular matrix to multiply by.
+     * @return A new dense matrix representing the product.
+     */
+    friend Matrix<T> operator*(
+        const Matrix<T>& lhs, const TriangularMatrix<T>& rhs
+    ) {
+        if (lhs.getCols() != rhs.size) throw std::invalid_argument(
+            "Incompatible dimensions for multiplication."
+        );
+        typedef typename Accumulator<T>::type Acc;
+        size_t n = rhs.size;
+        Matrix<T> result(lhs.getRows(), n);
+        const T* in = lhs.raw();
+        T* out = result.raw();
+        forEachRowBlock(lhs.getRows(), [&](size_t rowStart, size_t rowEnd) {
+            std::vector<Acc> sums(n);
+            for (size_t i = rowStart; i < rowEnd; ++i) {
+                std::fill(sums.begin(), sums.end(), Acc(0));
+                for (size_t k = 0; k < n; ++k) {
+                    Acc scale = in[i * n + k];
+                    const T* row = &rhs.packed[rhs.offset(k, rhs.firstCol(k))];
+                    for (size_t j = rhs.firstCol(k); j < rhs.endCol(k); ++j)
+                        sums[j] += scale * row[j - rhs.firstCol(k)];
+                }
+                for (size_t j = 0; j < n; ++j)
+                    out[i * n + j] = static_cast<T>(sums[j]);
+            }
+        });
+        return result;
+    }
+
+    /**
+     * Solves the triangular system T * X = B by forward (lower) or back
+     * (upper) substitution. Blocks of right-hand-side columns are solved
+     * in parallel; each row is reduced and divided in Accumulator<T>::type.
+     *
+     * @param rhs The right-hand side B.
+     * @return The solution X.
+     * @throws std::invalid_argument If the dimensions are incompatible.
+     * @throws std::domain_error If the matrix is singular.
+     */
+    Matrix<T> solve(const Matrix<T>& rhs) const {
+        if (size != rhs.getRows()) throw std::invalid_argument(
+            "Incompatible dimensions for triangular solve."
+        );
+        for (size_t i = 0; i < size; ++i) {
+            if (packed[offset(i, i)] == T(0)) throw std::domain_error(
+                "Triangular matrix is singular."
+            );
+        }
+        typedef typename Accumulator<T>::type Acc;
+        size_t n = rhs.getCols();
+        Matrix<T> X(rhs);
+        T* x = X.raw();
+        bool lower = triangle == Triangle::Lower;
+        size_t blockSize = 64;
+        ThreadPool::instance().parallelFor(
+            (n + blockSize - 1) / blockSize, [&](size_t b) {
+                size_t colStart = b * blockSize;
+                size_t colEnd = std::min(n, colStart + blockSize);
+                std::vector<Acc> sums(colEnd - colStart);
+                for (size_t step = 0; step < size; ++step) {
+                    size_t i = lower ? step : size - 1 - step;
+                    T* xi = x + i * n;
+                    for (size_t j = colStart; j < colEnd; ++j)
+                        sums[j - colStart] = xi[j];
+                    // X(i, :) -= T(i, k) * X(k, :) for the solved rows k
+                    size_t first = lower ? 0 : i + 1;
+                    size_t last = lower ? i : size;
+                    for (size_t k = first; k < last; ++k) {
+                        Acc scale = packed[offset(i, k)];
+                        const T* xk = x + k * n;
+                        for (size_t j = colStart; j < colEnd; ++j)
+                            sums[j - colStart] -= scale * xk[j];
+                    }
+                    Acc pivot = packed[offset(i, i)];
+                    for (size_t j = colStart; j < colEnd; ++j)
+                        xi[j] = static_cast<T>(sums[j - colStart] / pivot);
+                }
+            }
+        );
+        return X;
+    }
+};
+
+#endif // STRUCTUREDMATRIX_H
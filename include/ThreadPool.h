@@ -0,0 +1,307 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <functional>
+
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <condition_variable>
+
+#include <memory>
+#include <algorithm>
+
+#include <pthread.h>
+
+/**
+ * Thread Pool
+ *
+ * A fixed set of worker threads shared by every matrix operation, so that
+ * the tiles of independent operations interleave on the same workers
+ * instead of each operation spawning and joining its own threads.
+ *
+ * Threads that wait for work to finish (see waitUntil() and parallelFor())
+ * execute pending tasks while they wait. Operations may therefore be
+ * nested inside tasks without exhausting the pool.
+ *
+ * The shared pool survives fork(): fork handlers keep the pool locked
+ * while a process forks, and the child process, which inherits only the
+ * forking thread, starts new workers on its first use of the pool.
+ * Children that never use it start none.
+ *
+ * Usage example:
+ * ThreadPool::instance().parallelFor(10, [&](size_t i) { work(i); });
+ */
+class ThreadPool {
+private:
+    /**
+     * The queue and workers of a pool, replaced as a whole after a fork.
+     */
+    struct State {
+        std::mutex mutex;
+        std::condition_variable available;
+        std::condition_variable finished;
+        std::deque<std::function<void()>> tasks;
+        std::vector<std::thread> workers;
+        bool stopping = false;
+    };
+
+    std::unique_ptr<State> state;
+    // Set in a forked child, whose workers do not exist
+    std::atomic<bool> needsRestart;
+    // Serializes restarts; held across fork() with the state's mutex
+    std::mutex restartMutex;
+
+public:
+    /* ********************************************************************* */
+    /* ************************** Initialization *************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Constructs a pool with a fixed number of worker threads.
+     *
+     * @param threadCount Number of worker threads to start.
+     */
+    explicit ThreadPool(int threadCount) :
+        state(new State()), needsRestart(false) {
+        startWorkers(threadCount);
+    }
+
+    /**
+     * Finishes all pending tasks and joins the worker threads.
+     */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->stopping = true;
+        }
+        state->available.notify_all();
+        for (auto& worker : state->workers)
+            worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Returns the pool shared by the matrix library, with one worker per
+     * hardware thread. In a forked child the pool is restarted on first use.
+     *
+     * @return Reference to the shared pool.
+     */
+    static ThreadPool& instance() {
+        ThreadPool& pool = shared();
+        static bool forkHandlersInstalled = installForkHandlers();
+        (void)forkHandlersInstalled;
+        if (pool.needsRestart.load(std::memory_order_acquire))
+            pool.restartAfterFork();
+        return pool;
+    }
+
+    /* ********************************************************************* */
+    /* ***************************** Accessors ***************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Returns the number of worker threads in the pool.
+     *
+     * @return Integer count of worker threads.
+     */
+    int size() const {
+        return static_cast<int>(state->workers.size());
+    }
+
+    /* ********************************************************************* */
+    /* ************************** Task Submission ************************** */
+    /* ********************************************************************* */
+
+    /**
+     * Queues a task for execution on a worker thread. The task must not
+     * throw.
+     *
+     * @param task The task to execute.
+     */
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->tasks.push_back(std::move(task));
+        }
+        state->available.notify_one();
+        // Waiting threads also execute tasks
+        state->finished.notify_one();
+    }
+
+    /**
+     * Executes one pending task on the calling thread, if there is one.
+     *
+     * @return true if a task was executed; false if the queue was empty.
+     */
+    bool runPendingTask() {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->tasks.empty()) return false;
+            task = std::move(state->tasks.front());
+            state->tasks.pop_front();
+        }
+        task();
+        notifyWaiters();
+        return true;
+    }
+
+    /**
+     * Wakes threads blocked in waitUntil() so that they re-evaluate their
+     * condition. Must be called after changing state they may wait on.
+     */
+    void notifyWaiters() {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->finished.notify_all();
+    }
+
+    /**
+     * Blocks until a condition holds, executing pending tasks meanwhile.
+     * The condition must become true through a pool task or be followed by
+     * a call to notifyWaiters().
+     *
+     * @param done Predicate evaluated until it returns true.
+     */
+    template<typename Predicate>
+    void waitUntil(Predicate done) {
+        while (!done()) {
+            if (runPendingTask()) continue;
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->finished.wait(lock, [&]() {
+                return !state->tasks.empty() || done();
+            });
+        }
+    }
+
+    /**
+     * Runs body(0), ..., body(count - 1) on the pool and waits for all of
+     * them to finish. The first exception thrown by a task is rethrown.
+     *
+     * @param count Number of tasks to run.
+     * @param body Callable invoked with the index of each task.
+     */
+    template<typename Body>
+    void parallelFor(size_t count, Body body) {
+        if (count == 0) return;
+        std::atomic<size_t> remaining(count);
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        for (size_t i = 0; i < count; ++i) {
+            submit([&, i]() {
+                try {
+                    body(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) error = std::current_exception();
+                }
+                --remaining;
+            });
+        }
+        waitUntil([&]() { return remaining.load() == 0; });
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    /* ********************************************************************* */
+    /* ************************** Helper Functions ************************* */
+    /* ********************************************************************* */
+
+    /**
+     * Starts worker threads on the current state.
+     */
+    void startWorkers(int threadCount) {
+        for (int i = 0; i < threadCount; ++i)
+            state->workers.emplace_back(
+                &ThreadPool::workerLoop, this, state.get()
+            );
+    }
+
+    /**
+     * Main loop of each worker thread: executes queued tasks until the pool
+     * is stopped and the queue is drained.
+     *
+     * @param own The state the worker was started on.
+     */
+    void workerLoop(State* own) {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(own->mutex);
+                own->available.wait(lock, [own]() {
+                    return own->stopping || !own->tasks.empty();
+                });
+                if (own->tasks.empty()) return;
+                task = std::move(own->tasks.front());
+                own->tasks.pop_front();
+            }
+            task();
+            notifyWaiters();
+        }
+    }
+
+    /**
+     * Returns the shared pool without restarting it after a fork.
+     */
+    static ThreadPool& shared() {
+        static ThreadPool pool(
+            std::max(1, static_cast<int>(std::thread::hardware_concurrency()))
+        );
+        return pool;
+    }
+
+    /**
+     * Registers the fork handlers of the shared pool. The pool is locked
+     * while the process forks, so that the child never inherits a queue
+     * that is being modified; the child only marks the pool for restart.
+     * The state of a pool already marked is abandoned and not locked again.
+     *
+     * @return true, so that the registration can initialize a static.
+     */
+    static bool installForkHandlers() {
+        pthread_atfork(
+            []() {
+                ThreadPool& pool = shared();
+                pool.restartMutex.lock();
+                if (!pool.needsRestart.load(std::memory_order_relaxed))
+                    pool.state->mutex.lock();
+            },
+            []() {
+                ThreadPool& pool = shared();
+                if (!pool.needsRestart.load(std::memory_order_relaxed))
+                    pool.state->mutex.unlock();
+                pool.restartMutex.unlock();
+            },
+            []() {
+                ThreadPool& pool = shared();
+                pool.needsRestart.store(true, std::memory_order_relaxed);
+                pool.restartMutex.unlock();
+            }
+        );
+        return true;
+    }
+
+    /**
+     * Restores the pool in a child process with a new state and as many
+     * workers as before. The old state is abandoned, not destroyed: its
+     * threads do not exist in the child, so they can be neither joined nor
+     * destroyed, and its mutex is still held from the fork. Queued tasks
+     * belong to the parent and are dropped with it.
+     */
+    void restartAfterFork() {
+        std::lock_guard<std::mutex> guard(restartMutex);
+        if (!needsRestart.load(std::memory_order_relaxed)) return;
+        int threadCount = size();
+        state.release();
+        state.reset(new State());
+        startWorkers(threadCount);
+        needsRestart.store(false, std::memory_order_release);
+    }
+};
+
+#endif // THREADPOOL_H
@@ -1,6 +1,17 @@
 #include "MatrixLib.h"
+#include "MatrixAsync.h"
+#include "MatrixReader.h"
+#include "StructuredMatrix.h"
+#include "ProductCache.h"
+#include "MaintainedProduct.h"
+#include "DistributedMatrix.h"
 
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <iostream>
+#include <type_traits>
 
 // ANSI escape sequences for text formatting
 const std::string BOLD = "\033[1m";
@@ -218,6 +229,246 @@ void testKnownResultMultiplication() {
     }
 }
 
+/**
+ * Test for symmetric rank-k (Gram) products with known results.
+ */
+void testKnownGramProduct() {
+    std::cout << BOLD << "\t• Known Gram Product Test:" << RESET 
+              << " Demonstrate that gram(A) = A * A^T and A^T * A\n";
+    // Define matrices
+    Matrix<int> A = {
+        {1, 2, 3},
+        {4, 5, 6}
+    };
+    Matrix<int> KnownAAT = {
+        {14, 32},
+        {32, 77}
+    };
+    Matrix<int> KnownATA = {
+        {17, 22, 27},
+        {22, 29, 36},
+        {27, 36, 45}
+    };
+    Matrix<int> KnownUpperATA = {
+        {17, 22, 27},
+        {0, 29, 36},
+        {0, 0, 45}
+    };
+    Matrix<int> AAT = A.gram();
+    Matrix<int> ATA = A.gram(GramForm::ATA, Triangle::Upper);
+    Matrix<int> UpperATA = A.gram(GramForm::ATA, Triangle::Upper, false);
+    // Print matrices
+    std::cout << BOLD << "\t\t‣ Matrix A:" << RESET << "\n";
+    A.print(18);
+    // Perform test
+    if (AAT == KnownAAT && ATA == KnownATA && UpperATA == KnownUpperATA) {
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Gram products = Known Results" << RESET << "\n";
+        std::cout << GREEN + BOLD << "\t\t\t◦ Matrix A * A^T:" 
+                  << RESET << "\n";
+        AAT.print(26, GREEN);
+        std::cout << GREEN + BOLD << "\t\t\t◦ Matrix A^T * A (upper):" 
+                  << RESET << "\n";
+        UpperATA.print(26, GREEN);
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Gram products != Known Results" << RESET << "\n";
+        std::cout << RED + BOLD << "\t\t\t◦ Matrix A * A^T:" 
+                  << RESET << "\n";
+        AAT.print(26, RED);
+        std::cout << RED + BOLD << "\t\t\t◦ Matrix A^T * A (upper):" 
+                  << RESET << "\n";
+        UpperATA.print(26, RED);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test that Gram products spanning several blocks match operator*.
+ */
+void testBlockedGramProduct() {
+    std::cout << BOLD << "\t• Blocked Gram Product Test:" << RESET 
+              << " Demonstrate that gram(A) = A * A^T across blocks\n";
+    Matrix<int> A(300, 170);
+    for (size_t i = 0; i < A.getRows(); ++i)
+        for (size_t j = 0; j < A.getCols(); ++j)
+            A(i, j) = static_cast<int>((i * 31 + j * 17) % 11) - 5;
+    bool outer = A.gram() == A * A.transpose()
+        && A.gram(GramForm::AAT, Triangle::Upper) == A * A.transpose();
+    bool inner = A.gram(GramForm::ATA) == A.transpose() * A
+        && A.gram(GramForm::ATA, Triangle::Upper) == A.transpose() * A;
+    // Perform test
+    if (outer && inner) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": gram(A) = A * A^T and A^T * A" << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": gram(A) != A * A^T or A^T * A" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for multiplication with transposed operands.
+ */
+void testTransposedOperandMultiplication() {
+    std::cout << BOLD << "\t• Transposed Operand Test:" << RESET 
+              << " Demonstrate that multiply(A, op, B, op) = op(A) * op(B)\n";
+    // Define matrices spanning several blocks and depth slices
+    Matrix<int> A(150, 300);
+    Matrix<int> B(300, 140);
+    for (size_t i = 0; i < A.getRows(); ++i)
+        for (size_t j = 0; j < A.getCols(); ++j)
+            A(i, j) = static_cast<int>((i * 7 + j * 3) % 13) - 6;
+    for (size_t i = 0; i < B.getRows(); ++i)
+        for (size_t j = 0; j < B.getCols(); ++j)
+            B(i, j) = static_cast<int>((i * 5 + j * 11) % 9) - 4;
+    Matrix<int> AT = A.transpose();
+    Matrix<int> BT = B.transpose();
+    Matrix<int> Expected = A * B;
+    bool passed = multiply(AT, Op::Transpose, B, Op::None) == Expected
+        && multiply(A, Op::None, BT, Op::Transpose) == Expected
+        && multiply(AT, Op::Transpose, BT, Op::Transpose) == Expected
+        && multiply(A, Op::Transpose, A, Op::None) == AT * A;
+    // Perform test
+    if (passed) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": All operand combinations match" << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Operand combinations differ" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test that products accumulate in a wider type than their elements.
+ */
+void testWideAccumulation() {
+    std::cout << BOLD << "\t• Wide Accumulation Test:" << RESET 
+              << " Demonstrate that partial sums do not overflow or round\n";
+    // The partial sums 4e9 and 6e4 overflow int and short, 1e8 + 1 rounds
+    // to 1e8 in float. Solving L * x = b divides the short sum 6e4 by 2.
+    Matrix<int> A = {{2000000000, 2000000000, -2000000000}};
+    Matrix<short> S = {{30000, 30000, -30000}};
+    TriangularMatrix<short> L(Matrix<short>{{1, 0}, {1, 2}}, Triangle::Lower);
+    Matrix<short> b = {{-30000}, {30000}};
+    Matrix<float> F = {{1e8f, 1.0f, -1e8f}};
+    Matrix<int> onesInt = {{1}, {1}, {1}};
+    Matrix<short> onesShort = {{1}, {1}, {1}};
+    Matrix<float> onesFloat = {{1.0f}, {1.0f}, {1.0f}};
+    bool passed = (A * onesInt)(0, 0) == 2000000000
+        && multiply(onesInt, Op::Transpose, A, Op::Transpose)(0, 0) 
+           == 2000000000
+        && (S * onesShort)(0, 0) == 30000
+        && L.solve(b)(1, 0) == 30000
+        && (F * onesFloat)(0, 0) == 1.0f;
+    // Perform test
+    if (passed) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Sums of int, short and float products are exact" 
+                  << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Partial sums overflowed or were rounded" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Builds a matrix whose rows repeat big, 1, big, -big, -big, shifted by one
+ * per column, so that running sums along either dimension overflow int or
+ * drop the 1 in float.
+ */
+template<typename T>
+Matrix<T> makeCancellingMatrix(size_t rows, size_t cols, T big) {
+    const T pattern[5] = { big, T(1), big, -big, -big };
+    Matrix<T> M(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            M(i, j) = pattern[(i + j) % 5];
+    return M;
+}
+
+/**
+ * Checks that the structured, sparse, maintained and distributed kernels
+ * agree with operator* on products whose partial sums overflow or round.
+ */
+template<typename T>
+bool wideKernelsMatch(T big) {
+    const size_t size = 40;
+    Matrix<T> X = makeCancellingMatrix<T>(size, size, big);
+    Matrix<T> ones(size, size);
+    for (size_t i = 0; i < size; ++i)
+        for (size_t j = 0; j < size; ++j)
+            ones(i, j) = T(1);
+    TriangularMatrix<T> L(ones, Triangle::Lower);
+    BandedMatrix<T> B(ones, 7, 7);
+    DiagonalMatrix<T> D(std::vector<T>(size, T(3)));
+    Matrix<T> denseL = L.toDense();
+    // CSR form of L
+    std::vector<size_t> offsets(1, 0), indices;
+    std::vector<T> values;
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            indices.push_back(j);
+            values.push_back(T(1));
+        }
+        offsets.push_back(indices.size());
+    }
+    SparseMatrix<T> S(size, size, offsets, indices, values);
+    bool structured = L * X == denseL * X && X * L == X * denseL
+        && B * X == B.toDense() * X && X * B == X * B.toDense()
+        && D * X == D.toDense() * X && X * D == X * D.toDense()
+        && S * X == denseL * X;
+    // L * X is only exact in T for integers
+    bool solved = !std::is_integral<T>::value || L.solve(denseL * X) == X;
+    // C += U * (V^T * B) adds rows 0 to 4 of B to every row of C
+    MaintainedProduct<T> P(Matrix<T>(size, size), X);
+    Matrix<T> U(size, 5), V(size, 5);
+    for (size_t i = 0; i < size; ++i)
+        for (size_t l = 0; l < 5; ++l)
+            U(i, l) = T(1);
+    for (size_t l = 0; l < 5; ++l)
+        V(l, l) = T(1);
+    P.rankUpdate(U, V);
+    bool maintained = P.product() == P.getA() * P.getB();
+    // Blocks of 4 spread the inner dimension over 10 SUMMA steps
+    Matrix<T> C(0, 0);
+    LocalCluster::run(4, [&](Transport& transport) {
+        ProcessGrid grid(transport, 2, 2);
+        Matrix<T> product = summa(
+            DistributedMatrix<T>::distribute(grid, X, 4),
+            DistributedMatrix<T>::distribute(grid, X, 4)
+        ).gather();
+        if (transport.rank() == 0) C = product;
+    });
+    return structured && solved && maintained && C == X * X;
+}
+
+/**
+ * Test that the other multiplication kernels accumulate like operator*.
+ */
+void testWideKernelAccumulation() {
+    std::cout << BOLD << "\t• Wide Kernel Accumulation Test:" << RESET 
+              << " Demonstrate that all kernels match operator*\n";
+    // Running sums of 2e9 overflow int; 1e8 + 1 rounds to 1e8 in float
+    bool passed = wideKernelsMatch<int>(2000000000) 
+        && wideKernelsMatch<float>(1e8f);
+    // Perform test
+    if (passed) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Structured, sparse, maintained and SUMMA products "
+                  << "match" << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": A kernel overflowed or rounded its partial sums" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
 /**
  * Runs all the tests for matrix multiplication.
  */
@@ -228,6 +479,11 @@ void testMatrixMultiplication() {
     testRectangularMatrixMultiplication();
     testSymmetricResult();
     testKnownResultMultiplication();
+    testKnownGramProduct();
+    testBlockedGramProduct();
+    testTransposedOperandMultiplication();
+    testWideAccumulation();
+    testWideKernelAccumulation();
     std::cout << "\t• " << GREEN + BOLD
               << "Multiplication Tests completed successfully!" 
               << RESET << "\n";
@@ -534,6 +790,18 @@ void testInvalidMatrixMultiplication() {
                   << ": Exception thrown on invalid multiplication" 
                   << RESET << "\n";
     }
+    // Attempt invalid multiplication with a transposed operand
+    try { // This should throw an exception
+        Matrix<int> result = multiply(A, Op::None, B, Op::Transpose);
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": No exception on invalid multiplication (A * B^T)" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    } catch (const std::invalid_argument& e) {
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Exception thrown on invalid multiplication (A * B^T)" 
+                  << RESET << "\n";
+    }
 }
 
 /**
@@ -556,6 +824,38 @@ void testInvalidMatrixTransposition() {
     }
 }
 
+/**
+ * Test that copies share storage until one of them is modified.
+ */
+void testCopyOnWrite() {
+    std::cout << BOLD << "\t• Copy-On-Write Test:" << RESET 
+              << " Ensure copies share storage and detach on modification\n";
+    Matrix<int> A = {{1, 2}, {3, 4}};
+    Matrix<int> B = A;
+    const Matrix<int>& constA = A;
+    const Matrix<int>& constB = B;
+    bool shared = constA.raw() == constB.raw();
+    // Read-only operations must not detach the storage
+    Matrix<int> product = A * B;
+    Matrix<int> transposed = B.transpose();
+    bool stillShared = A == B && constA.raw() == constB.raw();
+    B(0, 0) = 9;
+    bool detached = constA.raw() != constB.raw() && A(0, 0) == 1 && 
+                    B(0, 0) == 9;
+    Matrix<int> moved = std::move(B);
+    bool emptied = B.getRows() == 0 && B.getCols() == 0 && moved(0, 0) == 9;
+    // Perform test
+    if (shared && stillShared && detached && emptied) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Copies share storage until modified" 
+                  << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Copy-on-write storage misbehaved" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
 /**
  * Run all the matrix edge case tests.
  */
@@ -564,50 +864,1138 @@ void testMatrixEdgeCases() {
     testEmptyMatrix();
     testInvalidMatrixMultiplication();
     testInvalidMatrixTransposition();
+    testCopyOnWrite();
     std::cout << "\t• " << GREEN + BOLD
               << "Matrix Edge Case Tests completed successfully!" 
               << RESET << "\n";
 }
 
 /* ********************************************************************* */
-/* ********************* Matrix Performance Tests ********************** */
+/* ******************* Matrix Factorization Tests ********************** */
 /* ********************************************************************* */
 
-void testMatrixPerformance() {
-    std::cout << BOLD << "Testing Matrix Performance:" << RESET << "\n";
-    const int size = 1000;
-    Matrix<int> largeMatrix(size, size);
-    // Testing Multiplication Performance
-    auto startMultiplication = std::chrono::high_resolution_clock::now();
-    Matrix<int> productMatrix = largeMatrix * largeMatrix;
-    auto endMultiplication = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double, std::milli> multiplicationDuration = 
-        endMultiplication - startMultiplication;
-    std::cout << "\t• Multiplication of " 
-              << BOLD << size << "x" << size << RESET << " matrix took " 
-              << BOLD << multiplicationDuration.count() << RESET
-              << " milliseconds.\n";
-    // Testing Transposition Performance
-    auto startTransposition = std::chrono::high_resolution_clock::now();
-    Matrix<int> transposedLargeMatrix = largeMatrix.transpose();
-    auto endTransposition = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double, std::milli> transpositionDuration = 
-        endTransposition - startTransposition;
-    std::cout << "\t• Transposition of " 
-              << BOLD << size << "x" << size << RESET << " matrix took " 
-              << BOLD << transpositionDuration.count() << RESET
-              << " milliseconds.\n";
+/**
+ * Returns the largest absolute element-wise difference of two matrices.
+ */
+double maxAbsDifference(const Matrix<double>& A, const Matrix<double>& B) {
+    double maxDifference = 0;
+    for (size_t i = 0; i < A.getRows(); ++i)
+        for (size_t j = 0; j < A.getCols(); ++j)
+            maxDifference = std::max(
+                maxDifference, std::fabs(A(i, j) - B(i, j))
+            );
+    return maxDifference;
 }
 
-int main() {
-    // Run Matrix Edge Case tests
-    testMatrixEdgeCases();
-    std::cout << "\n";
-    // Run Matrix Multiplication tests
-    testMatrixMultiplication();
-    std::cout << "\n";
-    // Run Matrix Transposition tests
-    testMatrixTransposition();
+/**
+ * Builds a deterministic, well-conditioned test matrix.
+ */
+Matrix<double> makeTestMatrix(int rows, int cols) {
+    Matrix<double> M(rows, cols);
+    for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j)
+            M(i, j) = ((i * 7 + j * 13) % 17) / 17.0 - 0.5 + (i == j ? 2 : 0);
+    return M;
+}
+
+/**
+ * Test for Cholesky factorization with a known result.
+ */
+void testKnownCholesky() {
+    std::cout << BOLD << "\t• Known Cholesky Test:" << RESET 
+              << " Demonstrate that chol(A) = Known L\n";
+    // Define matrices
+    Matrix<double> A = {
+        {4, 12, -16},
+        {12, 37, -43},
+        {-16, -43, 98}
+    };
+    Matrix<double> KnownL = {
+        {2, 0, 0},
+        {6, 1, 0},
+        {-8, 5, 3}
+    };
+    Matrix<double> L = A.cholesky();
+    // Print matrices
+    std::cout << BOLD << "\t\t‣ Matrix A:" << RESET << "\n";
+    A.print(18);
+    // Perform test
+    if (L == KnownL) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": L = Known L" << RESET << "\n";
+        std::cout << GREEN + BOLD << "\t\t\t◦ Matrix L:" << RESET << "\n";
+        L.print(26, GREEN);
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": L != Known L" << RESET << "\n";
+        std::cout << RED + BOLD << "\t\t\t◦ Matrix L:" << RESET << "\n";
+        L.print(26, RED);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for blocked Cholesky factorization spanning several panels.
+ */
+void testBlockedCholesky() {
+    std::cout << BOLD << "\t• Blocked Cholesky Test:" << RESET 
+              << " Demonstrate that L * L^T = A across multiple blocks\n";
+    const int size = 100;
+    Matrix<double> M = makeTestMatrix(size, size);
+    Matrix<double> A = M * M.transpose();
+    Matrix<double> L = A.cholesky(16);
+    double error = maxAbsDifference(L * L.transpose(), A);
+    bool lowerTriangular = true;
+    for (int i = 0; i < size; ++i)
+        for (int j = i + 1; j < size; ++j)
+            lowerTriangular = lowerTriangular && L(i, j) == 0;
+    // Perform test
+    if (lowerTriangular && error < 1e-9) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": max |L * L^T - A| = " << error << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": max |L * L^T - A| = " << error << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test that Cholesky factorization rejects indefinite matrices.
+ */
+void testInvalidCholesky() {
+    std::cout << BOLD << "\t• Invalid Cholesky Test:" << RESET 
+              << " Ensure an indefinite matrix throws an exception\n";
+    Matrix<double> A = {
+        {1, 2},
+        {2, 1}
+    };
+    try { // This should throw an exception
+        Matrix<double> L = A.cholesky();
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": No exception on indefinite matrix" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    } catch (const std::domain_error& e) {
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Exception thrown on indefinite matrix - " 
+                  << e.what() << RESET << "\n";
+    }
+}
+
+/**
+ * Checks that (Q, R) is a valid thin QR factorization of A.
+ */
+void checkQRFactorization(
+    const std::string& name, const Matrix<double>& A, QRMode mode
+) {
+    std::pair<Matrix<double>, Matrix<double>> QR = A.qr(mode, 8);
+    const Matrix<double>& Q = QR.first;
+    const Matrix<double>& R = QR.second;
+    size_t k = std::min(A.getRows(), A.getCols());
+    Matrix<double> I(k, k);
+    for (size_t i = 0; i < k; ++i)
+        I(i, i) = 1;
+    double error = maxAbsDifference(Q * R, A);
+    double orthogonality = maxAbsDifference(Q.transpose() * Q, I);
+    bool upperTriangular = true;
+    for (size_t i = 0; i < R.getRows(); ++i)
+        for (size_t j = 0; j < std::min(i, R.getCols()); ++j)
+            upperTriangular = upperTriangular && R(i, j) == 0;
+    // Perform test
+    if (upperTriangular && error < 1e-9 && orthogonality < 1e-9) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": " << name << " max |Q * R - A| = " << error 
+                  << ", max |Q^T * Q - I| = " << orthogonality 
+                  << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": " << name << " max |Q * R - A| = " << error 
+                  << ", max |Q^T * Q - I| = " << orthogonality 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for blocked Householder QR factorization.
+ */
+void testBlockedQR() {
+    std::cout << BOLD << "\t• Blocked QR Test:" << RESET 
+              << " Demonstrate that Q * R = A and Q^T * Q = I\n";
+    checkQRFactorization("60x25", makeTestMatrix(60, 25), QRMode::Blocked);
+    checkQRFactorization("20x45", makeTestMatrix(20, 45), QRMode::Blocked);
+}
+
+/**
+ * Test for tall-skinny (TSQR) QR factorization.
+ */
+void testTSQR() {
+    std::cout << BOLD << "\t• TSQR Test:" << RESET 
+              << " Demonstrate that Q * R = A and Q^T * Q = I\n";
+    checkQRFactorization("500x12", makeTestMatrix(500, 12), QRMode::TSQR);
+}
+
+/**
+ * Run all the matrix factorization tests.
+ */
+void testMatrixFactorization() {
+    std::cout << BOLD << "Testing Matrix Factorization:" << RESET << "\n";
+    testKnownCholesky();
+    testBlockedCholesky();
+    testInvalidCholesky();
+    testBlockedQR();
+    testTSQR();
+    std::cout << "\t• " << GREEN + BOLD
+              << "Factorization Tests completed successfully!" 
+              << RESET << "\n";
+}
+
+/* ********************************************************************* */
+/* ******************* Asynchronous Operation Tests ******************** */
+/* ********************************************************************* */
+
+/**
+ * Builds a deterministic integer test matrix.
+ */
+Matrix<int> makeIntegerMatrix(int rows, int cols, int seed) {
+    Matrix<int> M(rows, cols);
+    for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j)
+            M(i, j) = (i * 7 + j * 3 + seed) % 11 - 5;
+    return M;
+}
+
+/**
+ * Test for a graph of asynchronous multiplications.
+ */
+void testAsyncOperationGraph() {
+    std::cout << BOLD << "\t• Operation Graph Test:" << RESET 
+              << " Demonstrate that (A * B) * (C * D) matches when"
+              << " run asynchronously\n";
+    Matrix<int> A = makeIntegerMatrix(200, 150, 1);
+    Matrix<int> B = makeIntegerMatrix(150, 180, 2);
+    Matrix<int> C = makeIntegerMatrix(180, 140, 3);
+    Matrix<int> D = makeIntegerMatrix(140, 160, 4);
+    // Independent products run concurrently, the final one depends on both
+    MatrixFuture<int> AB = multiplyAsync(A, B);
+    MatrixFuture<int> CDT = transposeAsync(multiplyAsync(
+        MatrixFuture<int>(C), MatrixFuture<int>(D)
+    ));
+    MatrixFuture<int> Result = multiplyAsync(AB, Op::None, CDT, Op::Transpose);
+    Matrix<int> Expected = (A * B) * (C * D);
+    // Perform test
+    if (Result.get() == Expected) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Asynchronous Result = Synchronous Result" 
+                  << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Asynchronous Result != Synchronous Result" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for chaining continuations onto asynchronous operations.
+ */
+void testAsyncContinuation() {
+    std::cout << BOLD << "\t• Continuation Test:" << RESET 
+              << " Demonstrate that then() runs on the operation's result\n";
+    Matrix<int> M = {
+        {1, 2},
+        {3, 4}
+    };
+    Matrix<int> Expected = {
+        {10, 14},
+        {14, 20}
+    };
+    MatrixFuture<int> Result = transposeAsync(M).then(
+        [&M](const Matrix<int>& MT) { return MT * M; }
+    );
+    // Perform test
+    if (Result.get() == Expected) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": M^T * M = Expected" << RESET << "\n";
+        std::cout << GREEN + BOLD << "\t\t\t◦ Matrix M^T * M:" 
+                  << RESET << "\n";
+        Result.get().print(26, GREEN);
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": M^T * M != Expected" << RESET << "\n";
+        std::cout << RED + BOLD << "\t\t\t◦ Matrix M^T * M:" << RESET << "\n";
+        Result.get().print(26, RED);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test that errors propagate through dependent asynchronous operations.
+ */
+void testAsyncErrorPropagation() {
+    std::cout << BOLD << "\t• Error Propagation Test:" << RESET 
+              << " Ensure invalid operations fail their dependents\n";
+    Matrix<int> A = {{1, 2, 3}};
+    Matrix<int> B = {{1, 2}};
+    MatrixFuture<int> Invalid = multiplyAsync(A, B);
+    MatrixFuture<int> Dependent = transposeAsync(Invalid).then(
+        [](const Matrix<int>& M) { return M; }
+    );
+    try { // This should throw an exception
+        Dependent.get();
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": No exception from dependent operation" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    } catch (const std::invalid_argument& e) {
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Exception propagated to dependent operation - " 
+                  << e.what() << RESET << "\n";
+    }
+}
+
+/**
+ * Run all the asynchronous operation tests.
+ */
+void testAsyncOperations() {
+    std::cout << BOLD << "Testing Asynchronous Operations:" << RESET << "\n";
+    testAsyncOperationGraph();
+    testAsyncContinuation();
+    testAsyncErrorPropagation();
+    std::cout << "\t• " << GREEN + BOLD
+              << "Asynchronous Operation Tests completed successfully!" 
+              << RESET << "\n";
+}
+
+/* ********************************************************************* */
+/* ******************** Matrix Input/Output Tests ********************** */
+/* ********************************************************************* */
+
+/**
+ * Test for pretty output of floating-point matrices.
+ */
+void testPrettyFloatingOutput() {
+    std::cout << BOLD << "\t• Pretty Output Test:" << RESET 
+              << " Demonstrate that columns align for floating values\n";
+    Matrix<double> M = {
+        {0.5, -12.25},
+        {100, 3}
+    };
+    std::string expected = 
+        "\033[0m┌            ┐\n\033[0m"
+        "\033[0m| 0.5 -12.25 |\n\033[0m"
+        "\033[0m| 100      3 |\n\033[0m"
+        "\033[0m└            ┘\n\033[0m";
+    WriterOptions options;
+    options.color = "\033[0m";
+    std::ostringstream stream;
+    writeMatrix(stream, M, options);
+    // Perform test
+    if (stream.str() == expected) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Output = Expected" << RESET << "\n";
+        M.print(26, GREEN);
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Output != Expected" << RESET << "\n";
+        M.print(26, RED);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for delimited (CSV and TSV) output.
+ */
+void testDelimitedOutput() {
+    std::cout << BOLD << "\t• Delimited Output Test:" << RESET 
+              << " Demonstrate that CSV and TSV output match\n";
+    Matrix<int> M = {
+        {1, -2, 2147483647},
+        {-2147483647 - 1, 0, 30}
+    };
+    Matrix<double> D = {
+        {0.1, 1.0 / 3},
+        {-2.5e-300, 1e21}
+    };
+    WriterOptions csv;
+    csv.format = MatrixFormat::CSV;
+    WriterOptions tsv;
+    tsv.format = MatrixFormat::TSV;
+    std::ostringstream csvStream, tsvStream, doubleStream;
+    writeMatrix(csvStream, M, csv);
+    writeMatrix(tsvStream, M, tsv);
+    writeMatrix(doubleStream, D, csv);
+    bool passed = 
+        csvStream.str() == "1,-2,2147483647\n-2147483648,0,30\n"
+        && tsvStream.str() == "1\t-2\t2147483647\n-2147483648\t0\t30\n"
+        && doubleStream.str() == 
+            "0.1,0.3333333333333333\n-2.5e-300,1e+21\n";
+    // Perform test
+    if (passed) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Output = Expected" << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Output != Expected" << RESET << "\n"
+                  << csvStream.str() << tsvStream.str() << doubleStream.str();
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for streaming a large matrix to a file.
+ */
+void testFileOutput() {
+    std::cout << BOLD << "\t• File Output Test:" << RESET 
+              << " Demonstrate that a streamed file matches the text\n";
+    Matrix<int> M = makeIntegerMatrix(3000, 40, 5);
+    WriterOptions csv;
+    csv.format = MatrixFormat::CSV;
+    std::string path = "matrix_test_output.csv";
+    writeMatrix(path, M, csv);
+    std::ifstream file(path.c_str());
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::remove(path.c_str());
+    std::string expected;
+    for (size_t i = 0; i < M.getRows(); ++i) {
+        for (size_t j = 0; j < M.getCols(); ++j)
+            expected += (j > 0 ? "," : "") + std::to_string(M(i, j));
+        expected += "\n";
+    }
+    // Perform test
+    if (contents.str() == expected) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": File = Expected" << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": File != Expected" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Writes text to a file, replacing its contents.
+ */
+void writeTextFile(const std::string& path, const std::string& text) {
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file << text;
+}
+
+/**
+ * Test for reading CSV and TSV files.
+ */
+void testCSVInput() {
+    std::cout << BOLD << "\t• CSV Input Test:" << RESET 
+              << " Demonstrate that read(CSV) = Expected\n";
+    Matrix<double> Expected = {
+        {1.5, -2, 3e-3},
+        {0.1, 1e21, -0.0}
+    };
+    std::string path = "matrix_test_input.csv";
+    writeTextFile(path, "1.5, -2,3e-3\r\n\n0.1,1e21 , -0\r\n\n");
+    Matrix<double> FromCSV = readCSV<double>(path);
+    writeTextFile(path, "1.5\t-2\t0.003\n0.1\t1000000000000000000000\t0");
+    Matrix<double> FromTSV = readCSV<double>(path, '\t');
+    // A large file spanning several chunks round-trips through the writer
+    Matrix<int> Large = makeIntegerMatrix(3000, 40, 6);
+    WriterOptions csv;
+    csv.format = MatrixFormat::CSV;
+    writeMatrix(path, Large, csv);
+    Matrix<int> LargeFromCSV = readCSV<int>(path);
+    writeTextFile(path, "1,2\n3\n");
+    bool rejectsRagged = false;
+    try {
+        readCSV<int>(path);
+    } catch (const std::runtime_error&) {
+        rejectsRagged = true;
+    }
+    std::remove(path.c_str());
+    // Perform test
+    if (FromCSV == Expected && FromTSV == Expected && 
+        LargeFromCSV == Large && rejectsRagged) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": read(CSV) = Expected" << RESET << "\n";
+        FromCSV.print(26, GREEN);
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": read(CSV) != Expected" << RESET << "\n";
+        FromCSV.print(26, RED);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test that integers outside the range of the element type are rejected.
+ */
+void testOutOfRangeInput() {
+    std::cout << BOLD << "\t• Out-of-Range Input Test:" << RESET 
+              << " Ensure out-of-range integers throw exceptions\n";
+    std::string path = "matrix_test_input.csv";
+    auto rejects = [&path](const std::string& text) {
+        writeTextFile(path, text);
+        try {
+            readCSV<int>(path);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    bool rejected = rejects("1,3000000000\n") 
+        && rejects("-2147483649\n") 
+        && rejects("99999999999999999999\n");
+    writeTextFile(path, "2147483647,-2147483648\n");
+    Matrix<int> Limits = readCSV<int>(path);
+    std::remove(path.c_str());
+    bool limitsRead = Limits == Matrix<int>{{2147483647, -2147483647 - 1}};
+    // Perform test
+    if (rejected && limitsRead) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Out-of-range values throw, the limits are read" 
+                  << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Out-of-range values were not rejected" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for reading MatrixMarket files into dense and sparse matrices.
+ */
+void testMatrixMarketInput() {
+    std::cout << BOLD << "\t• MatrixMarket Input Test:" << RESET 
+              << " Demonstrate that read(.mtx) = Expected\n";
+    Matrix<double> Expected = {
+        {4, 0, -1},
+        {0, 2.5, 0},
+        {-1, 0, 7}
+    };
+    std::string path = "matrix_test_input.mtx";
+    writeTextFile(path, 
+        "%%MatrixMarket matrix coordinate real symmetric\n"
+        "% lower triangle only\n"
+        "3 3 4\n"
+        "1 1 4\n"
+        "3 1 -1\n"
+        "2 2 2.5\n"
+        "3 3 7\n");
+    Matrix<double> Coordinate = readMatrixMarket<double>(path);
+    SparseMatrix<double> Sparse = readMatrixMarketSparse<double>(path);
+    writeTextFile(path, 
+        "%%MatrixMarket matrix array real general\n"
+        "3 3\n"
+        "4\n0\n-1\n0\n2.5\n0\n-1\n0\n7\n");
+    Matrix<double> Array = readMatrixMarket<double>(path);
+    std::remove(path.c_str());
+    Matrix<double> B = makeTestMatrix(3, 4);
+    bool sparseMatches = Sparse.getNonZeros() == 5 
+        && Sparse.toDense() == Expected 
+        && maxAbsDifference(Sparse * B, Expected * B) < 1e-12;
+    // Perform test
+    if (Coordinate == Expected && Array == Expected && sparseMatches) {
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": read(.mtx) = Expected" << RESET << "\n";
+        Coordinate.print(26, GREEN);
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": read(.mtx) != Expected" << RESET << "\n";
+        Coordinate.print(26, RED);
+        Array.print(26, RED);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test that both MatrixMarket readers sum duplicate coordinate entries.
+ */
+void testDuplicateMatrixMarketEntries() {
+    std::cout << BOLD << "\t• Duplicate Entry Test:" << RESET 
+              << " Demonstrate that repeated entries are summed\n";
+    Matrix<double> Expected = {
+        {4, 7},
+        {7, 0}
+    };
+    // Padding comments put the repeated entries in different chunks
+    std::string padding;
+    for (int line = 0; line < 4096; ++line)
+        padding += "% padding line to spread the entries over chunks\n";
+    std::string path = "matrix_test_input.mtx";
+    writeTextFile(path, 
+        "%%MatrixMarket matrix coordinate real symmetric\n"
+        "2 2 4\n"
+        "1 1 1.5\n"
+        "2 1 3\n" + padding +
+        "1 2 4\n"
+        "1 1 2.5\n");
+    Matrix<double> Dense = readMatrixMarket<double>(path);
+    SparseMatrix<double> Sparse = readMatrixMarketSparse<double>(path);
+    std::remove(path.c_str());
+    // Perform test
+    if (Dense == Expected && Sparse.toDense() == Expected &&
+        Sparse.getNonZeros() == 3) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Dense and sparse readers sum duplicates" 
+                  << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Duplicate entries were not summed" << RESET << "\n";
+        Dense.print(26, RED);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Run all the matrix input and output tests.
+ */
+void testMatrixInputOutput() {
+    std::cout << BOLD << "Testing Matrix Input/Output:" << RESET << "\n";
+    testPrettyFloatingOutput();
+    testDelimitedOutput();
+    testFileOutput();
+    testCSVInput();
+    testOutOfRangeInput();
+    testMatrixMarketInput();
+    testDuplicateMatrixMarketEntries();
+    std::cout << "\t• " << GREEN + BOLD
+              << "Input/Output Tests completed successfully!" 
+              << RESET << "\n";
+}
+
+/* ********************************************************************* */
+/* ********************* Structured Matrix Tests *********************** */
+/* ********************************************************************* */
+
+/**
+ * Test for diagonal matrix scaling.
+ */
+void testDiagonalScaling() {
+    std::cout << BOLD << "\t• Diagonal Scaling Test:" << RESET 
+              << " Demonstrate that D * M and M * D scale rows and columns\n";
+    Matrix<int> M = {
+        {2, 3}, 
+        {4, 5}
+    };
+    DiagonalMatrix<int> I = DiagonalMatrix<int>::identity(2);
+    DiagonalMatrix<int> D(std::vector<int>{2, -1});
+    Matrix<int> KnownDM = {
+        {4, 6}, 
+        {-4, -5}
+    };
+    Matrix<int> KnownMD = {
+        {4, -3}, 
+        {8, -5}
+    };
+    // Print matrices
+    std::cout << BOLD << "\t\t‣ Matrix M:" << RESET << "\n";
+    M.print(18);
+    std::cout << BOLD << "\t\t‣ Diagonal Matrix D:" << RESET << "\n";
+    D.toDense().print(18);
+    // Perform test
+    if (I * M == M && M * I == M && D * M == KnownDM && M * D == KnownMD &&
+        (D * D).toDense() == D.toDense() * D.toDense()) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": IM = MI = M, D * M and M * D = Known results" 
+                  << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Diagonal products differ from known results" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for banded matrix multiplication against the dense product.
+ */
+void testBandedMultiplication() {
+    std::cout << BOLD << "\t• Banded Multiplication Test:" << RESET 
+              << " Demonstrate that banded products match dense products\n";
+    BandedMatrix<double> B(makeTestMatrix(150, 120), 1, 2);
+    Matrix<double> dense = B.toDense();
+    Matrix<double> left = makeTestMatrix(90, 150);
+    Matrix<double> right = makeTestMatrix(120, 70);
+    double error = std::max(
+        maxAbsDifference(left * B, left * dense),
+        maxAbsDifference(B * right, dense * right)
+    );
+    bool banded = dense(0, 2) != 0 && dense(0, 3) == 0 &&
+                  dense(1, 0) != 0 && dense(2, 0) == 0;
+    // Perform test
+    if (banded && error < 1e-12) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": max |banded - dense| = " << error << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": max |banded - dense| = " << error << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for triangular multiplication and solve.
+ */
+void testTriangularSolve() {
+    std::cout << BOLD << "\t• Triangular Solve Test:" << RESET 
+              << " Demonstrate that T * solve(T, B) = B for L and L^T\n";
+    const int size = 130;
+    Matrix<double> M = makeTestMatrix(size, size);
+    Matrix<double> A = M * M.transpose();
+    Matrix<double> dense = A.cholesky(32);
+    TriangularMatrix<double> L(dense, Triangle::Lower);
+    TriangularMatrix<double> U(dense.transpose(), Triangle::Upper);
+    Matrix<double> B = makeTestMatrix(size, 100);
+    double multiplyError = std::max(
+        maxAbsDifference(L * B, dense * B),
+        maxAbsDifference(B.transpose() * U, B.transpose() * dense.transpose())
+    );
+    double solveError = std::max(
+        maxAbsDifference(L * L.solve(B), B),
+        maxAbsDifference(U * U.solve(B), B)
+    );
+    // Perform test
+    if (multiplyError < 1e-9 && solveError < 1e-9) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": max |T * X - B| = " << solveError << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": max |T * X - B| = " << solveError 
+                  << ", max |product error| = " << multiplyError 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test that a singular triangular solve throws an exception.
+ */
+void testSingularTriangularSolve() {
+    std::cout << BOLD << "\t• Singular Triangular Solve Test:" << RESET 
+              << " Ensure a zero pivot throws an exception\n";
+    Matrix<double> A = {
+        {1, 0},
+        {2, 0}
+    };
+    TriangularMatrix<double> L(A, Triangle::Lower);
+    try { // This should throw an exception
+        Matrix<double> X = L.solve(A);
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": No exception on singular matrix" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    } catch (const std::domain_error& e) {
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Exception thrown on singular matrix - " 
+                  << e.what() << RESET << "\n";
+    }
+}
+
+/**
+ * Run all the structured matrix tests.
+ */
+void testStructuredMatrices() {
+    std::cout << BOLD << "Testing Structured Matrices:" << RESET << "\n";
+    testDiagonalScaling();
+    testBandedMultiplication();
+    testTriangularSolve();
+    testSingularTriangularSolve();
+    std::cout << "\t• " << GREEN + BOLD
+              << "Structured Matrix Tests completed successfully!" 
+              << RESET << "\n";
+}
+
+/* ********************************************************************* */
+/* *********************** Product Cache Tests ************************* */
+/* ********************************************************************* */
+
+/**
+ * Test for matrix content hashes.
+ */
+void testContentHash() {
+    std::cout << BOLD << "\t• Content Hash Test:" << RESET 
+              << " Demonstrate that hashes follow contents and dimensions\n";
+    Matrix<double> A = makeTestMatrix(600, 500);
+    Matrix<double> B(A);
+    bool copiesMatch = A.contentHash() == B.contentHash();
+    B(599, 499) = 7;
+    bool modificationDetected = A.contentHash() != B.contentHash();
+    B(599, 499) = A(599, 499);
+    bool restoredMatch = A.contentHash() == B.contentHash();
+    Matrix<int> wide = {{1, 2, 3}, {4, 5, 6}};
+    Matrix<int> tall = {{1, 2}, {3, 4}, {5, 6}};
+    bool shapeDetected = wide.contentHash() != tall.contentHash();
+    // Perform test
+    if (copiesMatch && modificationDetected && restoredMatch && 
+        shapeDetected) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Equal contents hash equally, changes are detected" 
+                  << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Hashes do not follow matrix contents" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for cache hits, misses and invalidation.
+ */
+void testProductCacheHits() {
+    std::cout << BOLD << "\t• Cache Hit Test:" << RESET 
+              << " Demonstrate that repeated products are served from cache\n";
+    ProductCache<int> cache(1 << 20);
+    Matrix<int> W = makeIntegerMatrix(40, 30, 1);
+    Matrix<int> x = makeIntegerMatrix(30, 5, 2);
+    Matrix<int> first = cache.multiply(W, x);
+    Matrix<int> second = cache.multiply(W, x);
+    bool hitCounted = cache.hits() == 1 && cache.misses() == 1;
+    x(0, 0) += 1;
+    Matrix<int> changed = cache.multiply(W, x);
+    Matrix<int> transposed = cache.multiply(W, Op::Transpose, W, Op::None);
+    bool missCounted = cache.hits() == 1 && cache.misses() == 3;
+    bool correct = first == second && second != changed && 
+                   changed == W * x && 
+                   transposed == W.transpose() * W;
+    // Perform test
+    if (hitCounted && missCounted && correct) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": " << cache.hits() << " hit, " << cache.misses() 
+                  << " misses, results match W * x" << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": " << cache.hits() << " hits, " << cache.misses() 
+                  << " misses" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for least recently used eviction under the memory cap.
+ */
+void testProductCacheEviction() {
+    std::cout << BOLD << "\t• Cache Eviction Test:" << RESET 
+              << " Demonstrate that the memory cap evicts the oldest result\n";
+    Matrix<int> A = makeIntegerMatrix(10, 10, 1);
+    Matrix<int> B = makeIntegerMatrix(10, 10, 2);
+    Matrix<int> C = makeIntegerMatrix(10, 10, 3);
+    // Room for two 10x10 results
+    ProductCache<int> cache(2 * 100 * sizeof(int));
+    cache.multiply(A, B);
+    cache.multiply(A, C);
+    cache.multiply(A, B); // A * B becomes the most recently used
+    cache.multiply(B, C); // Evicts A * C
+    cache.multiply(A, B);
+    cache.multiply(A, C);
+    bool evicted = cache.hits() == 2 && cache.misses() == 4;
+    bool capped = cache.size() == 2 && 
+                  cache.memoryUsage() <= cache.capacity();
+    // Perform test
+    if (evicted && capped) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": " << cache.size() << " results in " 
+                  << cache.memoryUsage() << " of " << cache.capacity() 
+                  << " bytes" << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": " << cache.hits() << " hits, " << cache.misses() 
+                  << " misses, " << cache.size() << " results" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Run all the product cache tests.
+ */
+void testProductCache() {
+    std::cout << BOLD << "Testing Product Cache:" << RESET << "\n";
+    testContentHash();
+    testProductCacheHits();
+    testProductCacheEviction();
+    std::cout << "\t• " << GREEN + BOLD
+              << "Product Cache Tests completed successfully!" 
+              << RESET << "\n";
+}
+
+/* ********************************************************************* */
+/* ********************* Maintained Product Tests ********************** */
+/* ********************************************************************* */
+
+/**
+ * Test for refreshing a product after row and column updates.
+ */
+void testMaintainedRowColumnUpdates() {
+    std::cout << BOLD << "\t• Row/Column Update Test:" << RESET 
+              << " Demonstrate that refreshed C matches A * B\n";
+    MaintainedProduct<int> P(
+        makeIntegerMatrix(200, 150, 1), makeIntegerMatrix(150, 180, 2)
+    );
+    P.setRowOfA(7, makeIntegerMatrix(1, 150, 3));
+    P.setA(120, 149, 42);
+    P.setColumnOfB(0, makeIntegerMatrix(150, 1, 4));
+    P.setB(99, 179, -17);
+    bool tracked = P.dirtyRowCount() == 2 && P.dirtyColCount() == 2;
+    bool correct = P.product() == P.getA() * P.getB();
+    bool cleared = P.dirtyRowCount() == 0 && P.dirtyColCount() == 0;
+    // Perform test
+    if (tracked && correct && cleared) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": C = A * B after 2 row and 2 column updates" 
+                  << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": C != A * B after row and column updates" 
+                  << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for rank-k updates combined with pending row updates.
+ */
+void testMaintainedRankUpdate() {
+    std::cout << BOLD << "\t• Rank Update Test:" << RESET 
+              << " Demonstrate that C += U * (V^T * B) matches A * B\n";
+    Matrix<int> A = makeIntegerMatrix(90, 70, 5);
+    MaintainedProduct<int> P(A, makeIntegerMatrix(70, 110, 6));
+    Matrix<int> U = makeIntegerMatrix(90, 2, 7);
+    Matrix<int> V = makeIntegerMatrix(70, 2, 8);
+    P.setA(3, 3, 9);
+    P.rankUpdate(U, V);
+    P.setB(0, 5, 1);
+    A(3, 3) = 9;
+    bool updatedA = P.getA() == A + U * V.transpose();
+    bool correct = P.product() == P.getA() * P.getB();
+    // Perform test
+    if (updatedA && correct) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": A = A + U * V^T and C = A * B" << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": Rank update is inconsistent" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Run all the maintained product tests.
+ */
+void testMaintainedProduct() {
+    std::cout << BOLD << "Testing Maintained Product:" << RESET << "\n";
+    testMaintainedRowColumnUpdates();
+    testMaintainedRankUpdate();
+    std::cout << "\t• " << GREEN + BOLD
+              << "Maintained Product Tests completed successfully!" 
+              << RESET << "\n";
+}
+
+/* ********************************************************************* */
+/* ******************** Distributed Multiplication Tests *************** */
+/* ********************************************************************* */
+
+/**
+ * Checks that SUMMA on a process grid reproduces the local product.
+ */
+void checkSumma(
+    const std::string& name, int gridRows, int gridCols, bool scattered
+) {
+    Matrix<int> A = makeIntegerMatrix(101, 70, 1);
+    Matrix<int> B = makeIntegerMatrix(70, 93, 2);
+    Matrix<int> C(0, 0);
+    // Small slots force messages to be split into chunks
+    LocalCluster::run(gridRows * gridCols, [&](Transport& transport) {
+        ProcessGrid grid(transport, gridRows, gridCols);
+        DistributedMatrix<int> dA = scattered
+            ? DistributedMatrix<int>::scatter(grid, A, 16)
+            : DistributedMatrix<int>::distribute(grid, A, 16);
+        DistributedMatrix<int> dB = scattered
+            ? DistributedMatrix<int>::scatter(grid, B, 16)
+            : DistributedMatrix<int>::distribute(grid, B, 16);
+        Matrix<int> product = summa(dA, dB).gather();
+        if (transport.rank() == 0) C = product;
+    }, 4096);
+    // Perform test
+    if (C == A * B) { // Success
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": " << name << " SUMMA = A * B" << RESET << "\n";
+    } else { // Failure
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": " << name << " SUMMA != A * B" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Test for SUMMA multiplication across worker processes.
+ */
+void testSummaMultiplication() {
+    std::cout << BOLD << "\t• SUMMA Test:" << RESET 
+              << " Demonstrate that distributed A * B matches local A * B\n";
+    checkSumma("2x2 grid, scattered", 2, 2, true);
+    checkSumma("1x3 grid, replicated", 1, 3, false);
+}
+
+/**
+ * Test that the failure of a worker process is reported.
+ */
+void testFailedWorkerProcess() {
+    std::cout << BOLD << "\t• Failed Process Test:" << RESET 
+              << " Ensure a failing worker process throws an exception\n";
+    try { // This should throw an exception
+        LocalCluster::run(3, [](Transport& transport) {
+            if (transport.rank() == 2) 
+                throw std::runtime_error("Worker failure.");
+            int message = 0;
+            if (transport.rank() == 0) 
+                transport.receive(2, &message, sizeof(message));
+        });
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": No exception on failed process" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    } catch (const std::runtime_error& e) {
+        if (std::string(e.what()) != "Process 2 failed: Worker failure.") {
+            std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" 
+                      << RESET + RED << ": Worker error not forwarded - " 
+                      << e.what() << RESET << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Exception thrown on failed process - " 
+                  << e.what() << RESET << "\n";
+    }
+}
+
+/**
+ * Test that a zero block size is rejected.
+ */
+void testZeroBlockSize() {
+    std::cout << BOLD << "\t• Block Size Test:" << RESET 
+              << " Ensure a zero block size throws an exception\n";
+    try { // This should throw an exception
+        LocalCluster::run(1, [](Transport& transport) {
+            ProcessGrid grid(transport, 1, 1);
+            DistributedMatrix<int> dA(grid, 10, 10, 0);
+        });
+        std::cout << "\t\t‣ " << RED + BOLD << "Test Failed" << RESET + RED
+                  << ": No exception on zero block size" << RESET << "\n";
+        std::exit(EXIT_FAILURE);
+    } catch (const std::invalid_argument& e) {
+        std::cout << "\t\t‣ " << GREEN + BOLD << "Test Passed" << RESET + GREEN
+                  << ": Exception thrown on zero block size - " 
+                  << e.what() << RESET << "\n";
+    }
+}
+
+/**
+ * Run all the distributed multiplication tests.
+ */
+void testDistributedMultiplication() {
+    std::cout << BOLD << "Testing Distributed Multiplication:" << RESET << "\n";
+    testSummaMultiplication();
+    testFailedWorkerProcess();
+    testZeroBlockSize();
+    std::cout << "\t• " << GREEN + BOLD
+              << "Distributed Multiplication Tests completed successfully!" 
+              << RESET << "\n";
+}
+
+/* ********************************************************************* */
+/* ********************* Matrix Performance Tests ********************** */
+/* ********************************************************************* */
+
+void testMatrixPerformance() {
+    std::cout << BOLD << "Testing Matrix Performance:" << RESET << "\n";
+    const int size = 1000;
+    Matrix<int> largeMatrix(size, size);
+    // Testing Multiplication Performance
+    auto startMultiplication = std::chrono::high_resolution_clock::now();
+    Matrix<int> productMatrix = largeMatrix * largeMatrix;
+    auto endMultiplication = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> multiplicationDuration = 
+        endMultiplication - startMultiplication;
+    std::cout << "\t• Multiplication of " 
+              << BOLD << size << "x" << size << RESET << " matrix took " 
+              << BOLD << multiplicationDuration.count() << RESET
+              << " milliseconds.\n";
+    // Testing Incremental Refresh Performance
+    MaintainedProduct<int> maintained(largeMatrix, largeMatrix);
+    auto startRefresh = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < 4; ++i)
+        maintained.setA(i * 250, i, 1);
+    maintained.rankUpdate(Matrix<int>(size, 1), Matrix<int>(size, 1));
+    maintained.product();
+    auto endRefresh = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> refreshDuration = 
+        endRefresh - startRefresh;
+    std::cout << "\t• Refresh of " 
+              << BOLD << size << "x" << size << RESET 
+              << " product after 4 row updates and a rank-1 update took " 
+              << BOLD << refreshDuration.count() << RESET
+              << " milliseconds.\n";
+    // Testing Transposition Performance
+    auto startTransposition = std::chrono::high_resolution_clock::now();
+    Matrix<int> transposedLargeMatrix = largeMatrix.transpose();
+    auto endTransposition = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> transpositionDuration = 
+        endTransposition - startTransposition;
+    std::cout << "\t• Transposition of " 
+              << BOLD << size << "x" << size << RESET << " matrix took " 
+              << BOLD << transpositionDuration.count() << RESET
+              << " milliseconds.\n";
+    // Testing Factorization Performance
+    Matrix<double> spdMatrix = makeTestMatrix(size, size).gram();
+    auto startCholesky = std::chrono::high_resolution_clock::now();
+    Matrix<double> choleskyFactor = spdMatrix.cholesky();
+    auto endCholesky = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> choleskyDuration = 
+        endCholesky - startCholesky;
+    std::cout << "\t• Cholesky factorization of " 
+              << BOLD << size << "x" << size << RESET << " matrix took " 
+              << BOLD << choleskyDuration.count() << RESET
+              << " milliseconds.\n";
+    Matrix<double> tallMatrix = makeTestMatrix(size, size / 4);
+    auto startQR = std::chrono::high_resolution_clock::now();
+    std::pair<Matrix<double>, Matrix<double>> tallQR = 
+        tallMatrix.qr(QRMode::Blocked);
+    auto endQR = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> qrDuration = endQR - startQR;
+    std::cout << "\t• QR factorization of " 
+              << BOLD << size << "x" << size / 4 << RESET << " matrix took " 
+              << BOLD << qrDuration.count() << RESET
+              << " milliseconds.\n";
+}
+
+int main() {
+    // Run Matrix Edge Case tests
+    testMatrixEdgeCases();
+    std::cout << "\n";
+    // Run Matrix Multiplication tests
+    testMatrixMultiplication();
+    std::cout << "\n";
+    // Run Matrix Transposition tests
+    testMatrixTransposition();
+    std::cout << "\n";
+    // Run Matrix Factorization tests
+    testMatrixFactorization();
+    std::cout << "\n";
+    // Run Asynchronous Operation tests
+    testAsyncOperations();
+    std::cout << "\n";
+    // Run Matrix Input/Output tests
+    testMatrixInputOutput();
+    std::cout << "\n";
+    // Run Structured Matrix tests
+    testStructuredMatrices();
+    std::cout << "\n";
+    // Run Product Cache tests
+    testProductCache();
+    std::cout << "\n";
+    // Run Maintained Product tests
+    testMaintainedProduct();
+    std::cout << "\n";
+    // Run Distributed Multiplication tests
+    testDistributedMultiplication();
     std::cout << "\n";
     // Run Matrix Performance tests
     testMatrixPerformance();